@@ -0,0 +1,172 @@
+/*
+ * udi_hid_digitizer.c
+ *
+ * Created: 10/17/2026
+ */ 
+#include "conf_usb.h"
+#include "usb_protocol.h"
+#include "udd.h"
+#include "udc.h"
+#include "udi_hid.h"
+#include "udi_hid_digitizer.h"
+#include <string.h>
+
+
+bool udi_hid_digitizer_enable(void);
+void udi_hid_digitizer_disable(void);
+bool udi_hid_digitizer_setup(void);
+uint8_t udi_hid_digitizer_getsetting(void);
+
+
+UDC_DESC_STORAGE udi_api_t udi_api_hid_digitizer = {
+	.enable     = udi_hid_digitizer_enable,
+	.disable    = udi_hid_digitizer_disable,
+	.setup      = udi_hid_digitizer_setup,
+	.getsetting = udi_hid_digitizer_getsetting,
+	.sof_notify = NULL,
+};
+
+COMPILER_WORD_ALIGNED
+		static uint8_t udi_hid_digitizer_rate;
+
+COMPILER_WORD_ALIGNED
+		static uint8_t udi_hid_digitizer_protocol;
+
+static bool udi_hid_digitizer_b_report_in_free;
+
+COMPILER_WORD_ALIGNED
+		static uint8_t udi_hid_digitizer_report_in[UDI_HID_DIGITIZER_REPORT_IN_SIZE];
+
+COMPILER_WORD_ALIGNED
+		static uint8_t udi_hid_digitizer_report_feature[2] = {
+			UDI_HID_DIGITIZER_ID_FEATURE,
+			1,				/* contact count maximum, both sliders make one contact */
+		};
+
+UDC_DESC_STORAGE udi_hid_digitizer_report_desc_t udi_hid_digitizer_report_desc = { {
+		0x05, 0x0D,					/* usage page (digitizers) */
+		0x09, 0x04,					/* usage (touch screen) */
+		0xA1, 0x01,					/* collection (application) */
+		  0x85, UDI_HID_DIGITIZER_ID_INPUT,	/* report id (contact) */
+		  0x09, 0x22,				/* usage (finger) */
+		  0xA1, 0x02,				/* collection (logical) */
+		    0x09, 0x42,				/* usage (tip switch) */
+		    0x09, 0x32,				/* usage (in range) */
+		    0x15, 0x00,				/* logical minimum (0) */
+		    0x25, 0x01,				/* logical maximum (1) */
+		    0x75, 0x01,				/* report size (1) */
+		    0x95, 0x02,				/* report count (2) */
+		    0x81, 0x02,				/* input (data,var,abs) */
+		    0x95, 0x06,				/* report count (6) */
+		    0x81, 0x03,				/* input (constant) */
+		    0x09, 0x51,				/* usage (contact identifier) */
+		    0x25, 0x7F,				/* logical maximum (127) */
+		    0x75, 0x08,				/* report size (8) */
+		    0x95, 0x01,				/* report count (1) */
+		    0x81, 0x02,				/* input (data,var,abs) */
+		    0x05, 0x01,				/* usage page (generic desktop) */
+		    0x26, 0xFF, 0x7F,		/* logical maximum (32767) */
+		    0x75, 0x10,				/* report size (16) */
+		    0x55, 0x0E,				/* unit exponent (-2), 0.1 mm */
+		    0x65, 0x11,				/* unit (cm) */
+		    0x35, 0x00,				/* physical minimum (0) */
+		    0x46,					/* physical maximum (width, 0.1 mm) */
+		      (uint8_t)(UDI_HID_DIGITIZER_WIDTH_MM * 10),
+		      (uint8_t)((UDI_HID_DIGITIZER_WIDTH_MM * 10) >> 8),
+		    0x09, 0x30,				/* usage (x) */
+		    0x81, 0x02,				/* input (data,var,abs) */
+		    0x46,					/* physical maximum (height, 0.1 mm) */
+		      (uint8_t)(UDI_HID_DIGITIZER_HEIGHT_MM * 10),
+		      (uint8_t)((UDI_HID_DIGITIZER_HEIGHT_MM * 10) >> 8),
+		    0x09, 0x31,				/* usage (y) */
+		    0x81, 0x02,				/* input (data,var,abs) */
+		    0x45, 0x00,				/* physical maximum (0), no units below */
+		    0x65, 0x00,				/* unit (none) */
+		    0x55, 0x00,				/* unit exponent (0) */
+		  0xC0,						/* end collection */
+		  0x05, 0x0D,				/* usage page (digitizers) */
+		  0x09, 0x54,				/* usage (contact count) */
+		  0x25, 0x7F,				/* logical maximum (127) */
+		  0x75, 0x08,				/* report size (8) */
+		  0x95, 0x01,				/* report count (1) */
+		  0x81, 0x02,				/* input (data,var,abs) */
+		  0x85, UDI_HID_DIGITIZER_ID_FEATURE,	/* report id (capabilities) */
+		  0x09, 0x55,				/* usage (contact count maximum) */
+		  0xB1, 0x02,				/* feature (data,var,abs) */
+		0xC0						/* end collection */
+	}
+};
+
+static bool udi_hid_digitizer_setreport(void);
+
+static void udi_hid_digitizer_report_in_sent(udd_ep_status_t status,
+	                                         iram_size_t     nb_sent,
+	                                         udd_ep_id_t     ep);
+
+/* --------------------------------------------------------------------- */
+
+bool udi_hid_digitizer_enable(void) {
+	udi_hid_digitizer_rate = 0;
+	udi_hid_digitizer_protocol = 0;
+	udi_hid_digitizer_b_report_in_free = true;
+
+	UDI_HID_DIGITIZER_ENABLE_EXT();
+	return true;
+}
+
+void udi_hid_digitizer_disable(void) {
+	UDI_HID_DIGITIZER_DISABLE_EXT();
+}
+
+bool udi_hid_digitizer_setup(void) {
+	return udi_hid_setup(&udi_hid_digitizer_rate,
+		                 &udi_hid_digitizer_protocol,
+		                (uint8_t *) &udi_hid_digitizer_report_desc,
+		                 udi_hid_digitizer_setreport);
+}
+
+uint8_t udi_hid_digitizer_getsetting(void) {
+	return 0;
+}
+
+static bool udi_hid_digitizer_setreport(void)
+{
+	if ((USB_HID_REPORT_TYPE_FEATURE == (udd_g_ctrlreq.req.wValue >> 8))        &&
+	   (UDI_HID_DIGITIZER_ID_FEATURE == (0xFF & udd_g_ctrlreq.req.wValue)) &&
+	    Udd_setup_is_in())                // GET_REPORT, read only
+	{
+		udd_g_ctrlreq.payload      = udi_hid_digitizer_report_feature;
+		udd_g_ctrlreq.payload_size = min(udd_g_ctrlreq.req.wLength,
+		                                 sizeof(udi_hid_digitizer_report_feature));
+		return true;
+	}
+	return false;
+}
+
+
+bool udi_hid_digitizer_send_report_in(uint8_t *data)
+{
+	if (!udi_hid_digitizer_b_report_in_free)
+		return false;
+	irqflags_t flags = cpu_irq_save();
+
+	memcpy(&udi_hid_digitizer_report_in,
+		   data,
+		   sizeof(udi_hid_digitizer_report_in));
+	udi_hid_digitizer_b_report_in_free = !udd_ep_run(UDI_HID_DIGITIZER_EP_IN,
+		                                             false,
+		                                             (uint8_t *) & udi_hid_digitizer_report_in,
+		                                             sizeof(udi_hid_digitizer_report_in),
+		                                             udi_hid_digitizer_report_in_sent);
+	cpu_irq_restore(flags);
+	return !udi_hid_digitizer_b_report_in_free;
+}
+
+static void udi_hid_digitizer_report_in_sent(udd_ep_status_t status,
+	                                         iram_size_t     nb_sent,
+	                                         udd_ep_id_t     ep) {
+	UNUSED(status);
+	UNUSED(nb_sent);
+	UNUSED(ep);
+	udi_hid_digitizer_b_report_in_free = true;
+}
@@ -0,0 +1,118 @@
+/*
+ * udi_hid_event.c
+ *
+ * Created: 10/17/2026
+ */ 
+#include "conf_usb.h"
+#include "usb_protocol.h"
+#include "udd.h"
+#include "udc.h"
+#include "udi_hid.h"
+#include "udi_hid_event.h"
+#include <string.h>
+
+
+bool udi_hid_event_enable(void);
+void udi_hid_event_disable(void);
+bool udi_hid_event_setup(void);
+uint8_t udi_hid_event_getsetting(void);
+
+
+UDC_DESC_STORAGE udi_api_t udi_api_hid_event = {
+	.enable     = udi_hid_event_enable,
+	.disable    = udi_hid_event_disable,
+	.setup      = udi_hid_event_setup,
+	.getsetting = udi_hid_event_getsetting,
+	.sof_notify = NULL,
+};
+
+COMPILER_WORD_ALIGNED
+		static uint8_t udi_hid_event_rate;
+
+COMPILER_WORD_ALIGNED
+		static uint8_t udi_hid_event_protocol;
+
+static bool udi_hid_event_b_report_in_free;
+
+COMPILER_WORD_ALIGNED
+		static uint8_t udi_hid_event_report_in[UDI_HID_EVENT_REPORT_IN_SIZE];
+
+UDC_DESC_STORAGE udi_hid_event_report_desc_t udi_hid_event_report_desc = { {
+		0x06, 0x00, 0xFF,	/* usage page (vendor)                   */
+		0x09, 0x03,			/* usage (vendor usage 3)                */
+		0xA1, 0x01,			/* collection (application)              */
+		  /* INPUT (device -> host), one timestamped transition      */
+		  0x09, 0x04,		/* usage (vendor usage 4)                */
+		  0x15, 0x00,		/* logical minimum (0)                   */
+		  0x26, 0xFF, 0x00,	/* logical maximum (255)                 */
+		  0x75, 0x08,		/* report size (8)                       */
+		  0x95, UDI_HID_EVENT_REPORT_IN_SIZE, /* report count            */
+		  0x81, 0x02,		/* input (data,var,abs)                  */
+		0xC0				/* end collection                        */
+	}
+};
+
+static bool udi_hid_event_setreport(void);
+
+static void udi_hid_event_report_in_sent(udd_ep_status_t status,
+	                                     iram_size_t     nb_sent,
+	                                     udd_ep_id_t     ep);
+
+/* --------------------------------------------------------------------- */
+
+bool udi_hid_event_enable(void) {
+	udi_hid_event_rate = 0;
+	udi_hid_event_protocol = 0;
+	udi_hid_event_b_report_in_free = true;
+
+	UDI_HID_EVENT_ENABLE_EXT();
+	return true;
+}
+
+void udi_hid_event_disable(void) {
+	UDI_HID_EVENT_DISABLE_EXT();
+}
+
+bool udi_hid_event_setup(void) {
+	return udi_hid_setup(&udi_hid_event_rate,
+		                 &udi_hid_event_protocol,
+		                (uint8_t *) &udi_hid_event_report_desc,
+		                 udi_hid_event_setreport);
+}
+
+uint8_t udi_hid_event_getsetting(void) {
+	return 0;
+}
+
+static bool udi_hid_event_setreport(void)
+{
+	return false;
+}
+
+
+bool udi_hid_event_send_report_in(uint8_t *data)
+{
+	if (!udi_hid_event_b_report_in_free)
+		return false;
+	irqflags_t flags = cpu_irq_save();
+
+	memcpy(&udi_hid_event_report_in,
+		   data,
+		   sizeof(udi_hid_event_report_in));
+	udi_hid_event_b_report_in_free = !udd_ep_run(UDI_HID_EVENT_EP_IN,
+		                                         false,
+		                                         (uint8_t *) & udi_hid_event_report_in,
+		                                         sizeof(udi_hid_event_report_in),
+		                                         udi_hid_event_report_in_sent);
+	cpu_irq_restore(flags);
+	return !udi_hid_event_b_report_in_free;
+}
+
+static void udi_hid_event_report_in_sent(udd_ep_status_t status,
+	                                     iram_size_t     nb_sent,
+	                                     udd_ep_id_t     ep) {
+	UNUSED(status);
+	UNUSED(nb_sent);
+	UNUSED(ep);
+	udi_hid_event_b_report_in_free = true;
+}
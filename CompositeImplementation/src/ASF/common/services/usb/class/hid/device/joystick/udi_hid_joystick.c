@@ -72,6 +72,37 @@ COMPILER_WORD_ALIGNED
 
 //! HID report descriptor for HID Joystick, modified by UniWest
 UDC_DESC_STORAGE udi_hid_joystick_report_desc_t udi_hid_joystick_report_desc = { { 
+#if UDI_HID_JSTK_HIRES
+	0x05, 0x01,                         /* usage page (generic desktop) */
+	0x09, 0x04,                         /* usage (joystick)             */
+	0xA1, 0x01,                         /* collection (application)     */
+	  0x05, 0x01,                       /* usage page (generic desktop) */
+	  0x09, 0x30,                       /* usage (x)                    */
+	  0x09, 0x31,                       /* usage (y)                    */
+	  0x15, 0x00,                       /* logical min (0)              */
+	  0x27, 0xFF, 0xFF, 0x00, 0x00,     /* logical max (65535)          */
+	  0x75, 0x10,                       /* report size (16)             */
+	  0x95, 0x02,                       /* report count (2)             */
+	  0x81, 0x02,                       /* input (data,var,abs)         */
+	  0x06, 0x00, 0xFF,                 /* usage page (vendor)          */
+	  0x09, 0x01,                       /* usage (x contact)            */
+	  0x09, 0x02,                       /* usage (y contact)            */
+	  0x15, 0x00,                       /* logical min (0)              */
+	  0x25, 0x01,                       /* logical max (1)              */
+	  0x75, 0x01,                       /* report size (1)              */
+	  0x95, 0x02,                       /* report count (2)             */
+	  0x81, 0x02,                       /* input (data,var,abs)         */
+	  0x75, 0x06,                       /* report size (6)              */
+	  0x95, 0x01,                       /* report count (1)             */
+	  0x81, 0x01,                       /* input (constant)             */
+	  0x09, 0x03,                       /* usage (USB frame number)     */
+	  0x15, 0x00,                       /* logical min (0)              */
+	  0x26, 0xFF, 0x07,                 /* logical max (2047)           */
+	  0x75, 0x10,                       /* report size (16)             */
+	  0x95, 0x01,                       /* report count (1)             */
+	  0x81, 0x02,                       /* input (data,var,abs)         */
+	0xC0                                /* end collection               */
+#else
 	0x05, 0x01,
 	0x09, 0x04,
 	0xA1, 0x01,
@@ -84,6 +115,7 @@ UDC_DESC_STORAGE udi_hid_joystick_report_desc_t udi_hid_joystick_report_desc = {
 	  0x95, 0x02,
 	  0x81, 0x02,
 	0xC0
+#endif
 	}
 };
 
@@ -46,7 +46,11 @@ typedef struct {
 
 //! Report descriptor for HID generic
 typedef struct {
+#if UDI_HID_JSTK_HIRES
+	uint8_t array[62]; // 16 bit axes, contact flags, frame number
+#else
 	uint8_t array[24]; // changed from 53 -> 27 -> 29
+#endif
 } udi_hid_joystick_report_desc_t;
 
 
@@ -55,6 +55,7 @@ bool udi_hid_kbd_enable(void);
 void udi_hid_kbd_disable(void);
 bool udi_hid_kbd_setup(void);
 uint8_t udi_hid_kbd_getsetting(void);
+void udi_hid_kbd_sof_notify(void);
 
 //! Global structure which contains standard UDI interface for UDC
 UDC_DESC_STORAGE udi_api_t udi_api_hid_kbd = {
@@ -62,7 +63,7 @@ UDC_DESC_STORAGE udi_api_t udi_api_hid_kbd = {
 	.disable = (void (*)(void))udi_hid_kbd_disable,
 	.setup = (bool(*)(void))udi_hid_kbd_setup,
 	.getsetting = (uint8_t(*)(void))udi_hid_kbd_getsetting,
-	.sof_notify = NULL,
+	.sof_notify = (void (*)(void))udi_hid_kbd_sof_notify,
 };
 //@}
 
@@ -80,8 +81,14 @@ UDC_DESC_STORAGE udi_api_t udi_api_hid_kbd = {
  */
 //@{
 
-//! Size of report for standard HID keyboard
-#define UDI_HID_KBD_REPORT_SIZE  8
+//! Size of the boot protocol report (modifiers, reserved, 6 key array)
+#define UDI_HID_KBD_BOOT_REPORT_SIZE  8
+//! Size of the report protocol report (modifiers, one bit per key usage)
+#define UDI_HID_KBD_REPORT_SIZE       (1 + (UDI_HID_KBD_NKRO_USAGE_MAX + 1) / 8)
+
+//! HID protocol values (SET_PROTOCOL wValue)
+#define UDI_HID_KBD_PROTOCOL_BOOT     0
+#define UDI_HID_KBD_PROTOCOL_REPORT   1
 
 
 //! To store current rate of HID keyboard
@@ -90,10 +97,27 @@ COMPILER_WORD_ALIGNED
 //! To store current protocol of HID keyboard
 COMPILER_WORD_ALIGNED
 		static uint8_t udi_hid_kbd_protocol;
-//! To signal if a valid report is ready to send
-static bool udi_hid_kbd_b_report_valid;
-//! Report ready to send
+//! Depth of the report snapshot queue
+#ifndef UDI_HID_KBD_QUEUE_SIZE
+#  define UDI_HID_KBD_QUEUE_SIZE  8
+#endif
+//! Called when a snapshot had to be merged into the newest queued one
+#ifndef UDI_HID_KBD_QUEUE_OVERFLOW
+#  define UDI_HID_KBD_QUEUE_OVERFLOW()
+#endif
+//! Called with the queue depth each time a snapshot is queued
+#ifndef UDI_HID_KBD_QUEUE_DEPTH
+#  define UDI_HID_KBD_QUEUE_DEPTH(depth)
+#endif
+
+//! Current keyboard state (modifiers, key bitmap), edited by the key/modifier functions
 static uint8_t udi_hid_kbd_report[UDI_HID_KBD_REPORT_SIZE];
+//! Snapshots of udi_hid_kbd_report waiting to be sent, oldest first
+static uint8_t udi_hid_kbd_queue[UDI_HID_KBD_QUEUE_SIZE][UDI_HID_KBD_REPORT_SIZE];
+//! Index of the oldest queued snapshot
+static uint8_t udi_hid_kbd_queue_head;
+//! Number of queued snapshots
+static uint8_t udi_hid_kbd_queue_count;
 //! Signal if a report transfer is on going
 static bool udi_hid_kbd_b_report_trans_ongoing;
 //! Buffer used to send report
@@ -103,7 +127,7 @@ COMPILER_WORD_ALIGNED
 
 //@}
 
-//! HID report descriptor for standard HID keyboard
+//! HID report descriptor for the N-key-rollover keyboard (report protocol)
 UDC_DESC_STORAGE udi_hid_kbd_report_desc_t udi_hid_kbd_report_desc = {
 	{
 				0x05, 0x01,	/* Usage Page (Generic Desktop)      */
@@ -117,14 +141,13 @@ UDC_DESC_STORAGE udi_hid_kbd_report_desc_t udi_hid_kbd_report_desc = {
 				0x75, 0x01,	/* Report Size (1)                   */
 				0x95, 0x08,	/* Report Count (8)                  */
 				0x81, 0x02,	/* Input (Data, Variable, Absolute)  */
-				0x81, 0x01,	/* Input (Constant)                  */
 				0x19, 0x00,	/* Usage Minimum (0)                 */
-				0x29, 101,	/* Usage Maximum (101)               */
+				0x29, UDI_HID_KBD_NKRO_USAGE_MAX,	/* Usage Maximum (103) */
 				0x15, 0x00,	/* Logical Minimum (0)               */
-				0x25, 101,	/* Logical Maximum (101)             */
-				0x75, 0x08,	/* Report Size (8)                   */
-				0x95, 0x06,	/* Report Count (6)                  */
-				0x81, 0x00,	/* Input (Data, Array)               */
+				0x25, 0x01,	/* Logical Maximum (1)               */
+				0x75, 0x01,	/* Report Size (1)                   */
+				0x95, UDI_HID_KBD_NKRO_USAGE_MAX + 1,	/* Report Count (104) */
+				0x81, 0x02,	/* Input (Data, Variable, Absolute)  */
 				0x05, 0x08,	/* Usage Page (LED)                  */
 				0x19, 0x01,	/* Usage Minimum (1)                 */
 				0x29, 0x05,	/* Usage Maximum (5)                 */
@@ -159,6 +182,25 @@ static bool udi_hid_kbd_setreport(void);
  */
 static bool udi_hid_kbd_send_report(void);
 
+/**
+ * \brief Queue a snapshot of the current report
+ *
+ * Every state change is sent in order, one report per IN transfer.
+ * When the queue is full the newest snapshot is overwritten, so the
+ * final state always reaches the host.
+ */
+static void udi_hid_kbd_queue_report(void);
+
+/**
+ * \brief Build a boot protocol report from a key bitmap snapshot
+ *
+ * Keys are listed in usage order, more than 6 keys give ErrorRollOver.
+ *
+ * \param boot      Boot report to fill (UDI_HID_KBD_BOOT_REPORT_SIZE)
+ * \param report    Snapshot (modifiers, key bitmap)
+ */
+static void udi_hid_kbd_build_boot(uint8_t *boot, uint8_t const *report);
+
 /**
  * \brief Callback called when the report is sent
  *
@@ -179,10 +221,12 @@ bool udi_hid_kbd_enable(void)
 {
 	// Initialize internal values
 	udi_hid_kbd_rate = 0;
-	udi_hid_kbd_protocol = 0;
+	// Report protocol is the default after reset, a BIOS switches to boot
+	udi_hid_kbd_protocol = UDI_HID_KBD_PROTOCOL_REPORT;
 	udi_hid_kbd_b_report_trans_ongoing = false;
 	memset(udi_hid_kbd_report, 0, UDI_HID_KBD_REPORT_SIZE);
-	udi_hid_kbd_b_report_valid = false;
+	udi_hid_kbd_queue_head = 0;
+	udi_hid_kbd_queue_count = 0;
 	return UDI_HID_KBD_ENABLE_EXT();
 }
 
@@ -208,6 +252,13 @@ uint8_t udi_hid_kbd_getsetting(void)
 }
 
 
+void udi_hid_kbd_sof_notify(void)
+{
+	// Retry a queued snapshot whose transfer could not be started
+	udi_hid_kbd_send_report();
+}
+
+
 static bool udi_hid_kbd_setreport(void)
 {
 	return false;
@@ -223,7 +274,7 @@ bool udi_hid_kbd_modifier_up(uint8_t modifier_id)
 
 	// Fill report
 	udi_hid_kbd_report[0] &= ~(unsigned)modifier_id;
-	udi_hid_kbd_b_report_valid = true;
+	udi_hid_kbd_queue_report();
 
 	// Send report
 	udi_hid_kbd_send_report();
@@ -239,7 +290,7 @@ bool udi_hid_kbd_modifier_down(uint8_t modifier_id)
 
 	// Fill report
 	udi_hid_kbd_report[0] |= modifier_id;
-	udi_hid_kbd_b_report_valid = true;
+	udi_hid_kbd_queue_report();
 
 	// Send report
 	udi_hid_kbd_send_report();
@@ -251,32 +302,23 @@ bool udi_hid_kbd_modifier_down(uint8_t modifier_id)
 
 bool udi_hid_kbd_up(uint8_t key_id)
 {
-	uint8_t i;
+	uint8_t *byte;
+	uint8_t mask;
+
+	if (key_id > UDI_HID_KBD_NKRO_USAGE_MAX)
+		return false;
+	byte = &udi_hid_kbd_report[1 + (key_id >> 3)];
+	mask = 1 << (key_id & 7);
 
 	irqflags_t flags = cpu_irq_save();
 
-	// Fill report
-	for (i = 2; i < UDI_HID_KBD_REPORT_SIZE; i++) {
-		if (0 == udi_hid_kbd_report[i]) {
-			// Already removed
-			cpu_irq_restore(flags);
-			return true;
-		}
-		if (key_id == udi_hid_kbd_report[i])
-			break;
-	}
-	if (UDI_HID_KBD_REPORT_SIZE == i) {
+	if (!(*byte & mask)) {
 		// Already removed
 		cpu_irq_restore(flags);
 		return true;
 	}
-	// Remove key and shift
-	while (i < (UDI_HID_KBD_REPORT_SIZE - 1)) {
-		udi_hid_kbd_report[i] = udi_hid_kbd_report[i + 1];
-		i++;
-	}
-	udi_hid_kbd_report[UDI_HID_KBD_REPORT_SIZE - 1] = 0x00;
-	udi_hid_kbd_b_report_valid = true;
+	*byte &= ~mask;
+	udi_hid_kbd_queue_report();
 
 	// Send report
 	udi_hid_kbd_send_report();
@@ -288,30 +330,23 @@ bool udi_hid_kbd_up(uint8_t key_id)
 
 bool udi_hid_kbd_down(uint8_t key_id)
 {
-	uint8_t i;
+	uint8_t *byte;
+	uint8_t mask;
 
-	irqflags_t flags = cpu_irq_save();
+	if (key_id > UDI_HID_KBD_NKRO_USAGE_MAX)
+		return false;
+	byte = &udi_hid_kbd_report[1 + (key_id >> 3)];
+	mask = 1 << (key_id & 7);
 
-	// Fill report
-	for (i = 2; i < UDI_HID_KBD_REPORT_SIZE; i++) {
-		if (0 == udi_hid_kbd_report[i])
-			break;
-		if (key_id == udi_hid_kbd_report[i]) {
-			// Already in array
-			cpu_irq_restore(flags);
-			return true;
-		}
-	}
+	irqflags_t flags = cpu_irq_save();
 
-	if (UDI_HID_KBD_REPORT_SIZE == i) {
-		// Array full
-		// TODO manage more than UDI_HID_KBD_REPORT_SIZE key pressed in same time
+	if (*byte & mask) {
+		// Already in bitmap
 		cpu_irq_restore(flags);
-		return false;
+		return true;
 	}
-	// Add key at the end of array
-	udi_hid_kbd_report[i] = key_id;
-	udi_hid_kbd_b_report_valid = true;
+	*byte |= mask;
+	udi_hid_kbd_queue_report();
 
 	// Send report
 	udi_hid_kbd_send_report();
@@ -322,22 +357,106 @@ bool udi_hid_kbd_down(uint8_t key_id)
 }
 
 
+bool udi_hid_kbd_set(uint8_t const *key_ids, uint8_t nb_key)
+{
+	uint8_t keys[UDI_HID_KBD_REPORT_SIZE - 1];
+	bool b_valid = true;
+
+	memset(keys, 0, sizeof(keys));
+	for (uint8_t i = 0; i < nb_key; i++) {
+		if ((0 == key_ids[i]) || (key_ids[i] > UDI_HID_KBD_NKRO_USAGE_MAX)) {
+			b_valid = (0 == key_ids[i]) && b_valid;
+			continue;
+		}
+		keys[key_ids[i] >> 3] |= 1 << (key_ids[i] & 7);
+	}
+
+	irqflags_t flags = cpu_irq_save();
+
+	if (memcmp(&udi_hid_kbd_report[1], keys, sizeof(keys))) {
+		memcpy(&udi_hid_kbd_report[1], keys, sizeof(keys));
+		udi_hid_kbd_queue_report();
+
+		// Send report
+		udi_hid_kbd_send_report();
+	}
+
+	cpu_irq_restore(flags);
+	return b_valid;
+}
+
+
 //--------------------------------------------
 //------ Internal routines
 
+static void udi_hid_kbd_queue_report(void)
+{
+	uint8_t slot;
+
+	if (UDI_HID_KBD_QUEUE_SIZE == udi_hid_kbd_queue_count) {
+		// Queue full, merge into the newest snapshot
+		slot = (udi_hid_kbd_queue_head + udi_hid_kbd_queue_count - 1)
+				% UDI_HID_KBD_QUEUE_SIZE;
+		UDI_HID_KBD_QUEUE_OVERFLOW();
+	} else {
+		slot = (udi_hid_kbd_queue_head + udi_hid_kbd_queue_count)
+				% UDI_HID_KBD_QUEUE_SIZE;
+		udi_hid_kbd_queue_count++;
+		UDI_HID_KBD_QUEUE_DEPTH(udi_hid_kbd_queue_count);
+	}
+	memcpy(udi_hid_kbd_queue[slot], udi_hid_kbd_report,
+			UDI_HID_KBD_REPORT_SIZE);
+}
+
+static void udi_hid_kbd_build_boot(uint8_t *boot, uint8_t const *report)
+{
+	uint8_t nb_key = 0;
+
+	memset(boot, 0, UDI_HID_KBD_BOOT_REPORT_SIZE);
+	boot[0] = report[0];
+	for (uint8_t i = 1; i < UDI_HID_KBD_REPORT_SIZE; i++) {
+		uint8_t bits = report[i];
+		while (bits) {
+			if ((UDI_HID_KBD_BOOT_REPORT_SIZE - 2) == nb_key) {
+				// Too many keys for the boot report
+				memset(&boot[2], 0x01, UDI_HID_KBD_BOOT_REPORT_SIZE - 2);
+				return;
+			}
+			boot[2 + nb_key++] = ((i - 1) << 3) + ctz(bits);
+			bits &= bits - 1;
+		}
+	}
+}
+
 static bool udi_hid_kbd_send_report(void)
 {
+	uint8_t const *snapshot;
+	iram_size_t size = UDI_HID_KBD_REPORT_SIZE;
+
 	if (udi_hid_kbd_b_report_trans_ongoing)
 		return false;
-	memcpy(udi_hid_kbd_report_trans, udi_hid_kbd_report,
-			UDI_HID_KBD_REPORT_SIZE);
-	udi_hid_kbd_b_report_valid = false;
+	if (0 == udi_hid_kbd_queue_count)
+		return false;
+	snapshot = udi_hid_kbd_queue[udi_hid_kbd_queue_head];
+	if (UDI_HID_KBD_PROTOCOL_BOOT == udi_hid_kbd_protocol) {
+		udi_hid_kbd_build_boot(udi_hid_kbd_report_trans, snapshot);
+		size = UDI_HID_KBD_BOOT_REPORT_SIZE;
+	} else {
+		memcpy(udi_hid_kbd_report_trans, snapshot,
+				UDI_HID_KBD_REPORT_SIZE);
+	}
 	udi_hid_kbd_b_report_trans_ongoing =
 			udd_ep_run(	UDI_HID_KBD_EP_IN,
 							false,
 							udi_hid_kbd_report_trans,
-							UDI_HID_KBD_REPORT_SIZE,
+							size,
 							udi_hid_kbd_report_sent);
+	if (udi_hid_kbd_b_report_trans_ongoing) {
+		// Snapshot is on its way, otherwise it stays queued for the next try
+		udi_hid_kbd_queue_head = (udi_hid_kbd_queue_head + 1)
+				% UDI_HID_KBD_QUEUE_SIZE;
+		udi_hid_kbd_queue_count--;
+	}
 	return udi_hid_kbd_b_report_trans_ongoing;
 }
 
@@ -348,9 +467,7 @@ static void udi_hid_kbd_report_sent(udd_ep_status_t status, iram_size_t nb_sent,
 	UNUSED(nb_sent);
 	UNUSED(ep);
 	udi_hid_kbd_b_report_trans_ongoing = false;
-	if (udi_hid_kbd_b_report_valid) {
-		udi_hid_kbd_send_report();
-	}
+	udi_hid_kbd_send_report();
 }
 
 //@}
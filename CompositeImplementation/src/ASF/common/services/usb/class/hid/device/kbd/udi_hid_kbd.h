@@ -73,7 +73,7 @@ typedef struct {
 
 //! Report descriptor for HID keyboard
 typedef struct {
-	uint8_t array[59];
+	uint8_t array[57];
 } udi_hid_kbd_report_desc_t;
 
 
@@ -83,7 +83,7 @@ typedef struct {
 #endif
 
 //! HID keyboard endpoints size
-#define UDI_HID_KBD_EP_SIZE  8
+#define UDI_HID_KBD_EP_SIZE  16
 
 //! Content of HID keyboard interface descriptor for all speed
 #define UDI_HID_KBD_DESC    {\
@@ -93,8 +93,8 @@ typedef struct {
 	.iface.bAlternateSetting   = 0,\
 	.iface.bNumEndpoints       = 1,\
 	.iface.bInterfaceClass     = HID_CLASS,\
-	.iface.bInterfaceSubClass  = HID_SUB_CLASS_NOBOOT,\
-	.iface.bInterfaceProtocol  = HID_PROTOCOL_GENERIC,\
+	.iface.bInterfaceSubClass  = HID_SUB_CLASS_BOOT,\
+	.iface.bInterfaceProtocol  = HID_PROTOCOL_KEYBOARD,\
 	.iface.iInterface          = UDI_HID_KBD_STRING_ID,\
 	.hid.bLength               = sizeof(usb_hid_descriptor_t),\
 	.hid.bDescriptorType       = USB_DT_HID,\
@@ -123,6 +123,9 @@ typedef struct {
  * @{
  */
 
+//! Highest key usage covered by the N-key-rollover bitmap, higher usages are refused
+#define UDI_HID_KBD_NKRO_USAGE_MAX    103
+
 /**
  * \brief Send events key modifier released
  *
@@ -156,9 +159,22 @@ bool udi_hid_kbd_up(uint8_t key_id);
  *
  * \param key_id   ID of key
  *
+ * \return \c 1 if function was successfully done, \c 0 if key_id is out of the bitmap.
  */
 bool udi_hid_kbd_down(uint8_t key_id);
 
+/**
+ * \brief Replace every pressed key in one report (modifiers are kept)
+ *
+ * A chord reaches the host as a single report instead of one per key.
+ *
+ * \param key_ids   IDs of the keys held, 0 entries are skipped
+ * \param nb_key    Number of entries in key_ids
+ *
+ * \return \c 1 if every key fit in the bitmap, otherwise \c 0.
+ */
+bool udi_hid_kbd_set(uint8_t const *key_ids, uint8_t nb_key);
+
 //@}
 
 #ifdef __cplusplus
@@ -41,8 +41,8 @@ COMPILER_WORD_ALIGNED
 COMPILER_WORD_ALIGNED
 		static uint8_t udi_hid_led_report_out[UDI_HID_LED_REPORT_OUT_SIZE];
 
-// COMPILER_WORD_ALIGNED
-// 		static uint8_t udi_hid_led_report_feature[UDI_HID_REPORT_FEATURE_SIZE];
+COMPILER_WORD_ALIGNED
+		static uint8_t udi_hid_led_report_feature[UDI_HID_LED_REPORT_FEATURE_SIZE];
 
 UDC_DESC_STORAGE udi_hid_led_report_desc_t udi_hid_led_report_desc = { {
 		0x06, 0x00, 0xFF,	/* usage page (vendor)      */
@@ -60,6 +60,11 @@ UDC_DESC_STORAGE udi_hid_led_report_desc_t udi_hid_led_report_desc = { {
 		  0x19, 0x01,		/* usage min                */
 		  0x29, 0x10,		/* usage max                */
 		  0x91, 0x02,		/* output (data,var,abs)    */
+		  /* FEATURE (both directions)                  */
+		  0x95, 0x40,		/* report count             */
+		  0x75, 0x08,		/* report size              */
+		  0x09, 0x02,		/* usage (vendor usage 2)   */
+		  0xB1, 0x02,		/* feature (data,var,abs)   */
 		0xC0          		/* end collection           */
 	}
 };
@@ -72,7 +77,7 @@ static void udi_hid_led_report_out_received(udd_ep_status_t status,
 
 static bool udi_hid_led_report_out_enable(void);
 
-// static void udi_hid_led_setfeature_valid(void);
+static void udi_hid_led_setfeature_valid(void);
 
 static void udi_hid_led_report_in_sent(udd_ep_status_t status,
 	                                   iram_size_t     nb_sent,
@@ -117,6 +122,23 @@ static bool udi_hid_led_setreport(void)
 		udd_g_ctrlreq.callback     = udi_hid_led_report_out_received;
 		return true;
 	}
+	if ((USB_HID_REPORT_TYPE_FEATURE == (udd_g_ctrlreq.req.wValue >> 8)) &&
+	   (0 == (0xFF & udd_g_ctrlreq.req.wValue)))
+	{
+		if (Udd_setup_is_in()) {          // GET_REPORT
+			UDI_HID_LED_GET_FEATURE(udi_hid_led_report_feature);
+			udd_g_ctrlreq.payload      = udi_hid_led_report_feature;
+			udd_g_ctrlreq.payload_size = min(udd_g_ctrlreq.req.wLength,
+			                                 UDI_HID_LED_REPORT_FEATURE_SIZE);
+			return true;
+		}
+		if (UDI_HID_LED_REPORT_FEATURE_SIZE == udd_g_ctrlreq.req.wLength) {
+			udd_g_ctrlreq.payload      = udi_hid_led_report_feature;
+			udd_g_ctrlreq.payload_size = UDI_HID_LED_REPORT_FEATURE_SIZE;
+			udd_g_ctrlreq.callback     = udi_hid_led_setfeature_valid;
+			return true;
+		}
+	}
 	return false;
 }
 
@@ -162,10 +184,11 @@ bool udi_hid_led_send_report_in(uint8_t *data)
 	return !udi_hid_led_b_report_in_free;
 }
 
-// static void udi_hid_led_setfeature_valid(void) {
-// 	if (sizeof(udi_hid_led_report_feature) != udd_g_ctrlreq.payload_size)
-// 		return; //BAD BAD BAD
-// }
+static void udi_hid_led_setfeature_valid(void) {
+	if (sizeof(udi_hid_led_report_feature) != udd_g_ctrlreq.payload_size)
+		return;
+	UDI_HID_LED_SET_FEATURE(udi_hid_led_report_feature);
+}
 
 static void udi_hid_led_report_in_sent(udd_ep_status_t status,
 	                                   iram_size_t     nb_sent,
@@ -0,0 +1,136 @@
+/*
+ * udi_hid_pointer.c
+ *
+ * Created: 10/17/2026
+ */ 
+#include "conf_usb.h"
+#include "usb_protocol.h"
+#include "udd.h"
+#include "udc.h"
+#include "udi_hid.h"
+#include "udi_hid_pointer.h"
+#include <string.h>
+
+
+bool udi_hid_pointer_enable(void);
+void udi_hid_pointer_disable(void);
+bool udi_hid_pointer_setup(void);
+uint8_t udi_hid_pointer_getsetting(void);
+
+
+UDC_DESC_STORAGE udi_api_t udi_api_hid_pointer = {
+	.enable     = udi_hid_pointer_enable,
+	.disable    = udi_hid_pointer_disable,
+	.setup      = udi_hid_pointer_setup,
+	.getsetting = udi_hid_pointer_getsetting,
+	.sof_notify = NULL,
+};
+
+COMPILER_WORD_ALIGNED
+		static uint8_t udi_hid_pointer_rate;
+
+COMPILER_WORD_ALIGNED
+		static uint8_t udi_hid_pointer_protocol;
+
+static bool udi_hid_pointer_b_report_in_free;
+
+COMPILER_WORD_ALIGNED
+		static uint8_t udi_hid_pointer_report_in[UDI_HID_POINTER_REPORT_IN_SIZE];
+
+UDC_DESC_STORAGE udi_hid_pointer_report_desc_t udi_hid_pointer_report_desc = { {
+		0x05, 0x01,			/* usage page (generic desktop) */
+		0x09, 0x02,			/* usage (mouse)                */
+		0xA1, 0x01,			/* collection (application)     */
+		  0x09, 0x01,		/* usage (pointer)              */
+		  0xA1, 0x00,		/* collection (physical)        */
+		    /* buttons (unused, always 0)                   */
+		    0x05, 0x09,		/* usage page (button)          */
+		    0x19, 0x01,		/* usage minimum (1)            */
+		    0x29, 0x03,		/* usage maximum (3)            */
+		    0x15, 0x00,		/* logical minimum (0)          */
+		    0x25, 0x01,		/* logical maximum (1)          */
+		    0x95, 0x03,		/* report count (3)             */
+		    0x75, 0x01,		/* report size (1)              */
+		    0x81, 0x02,		/* input (data,var,abs)         */
+		    0x95, 0x01,		/* report count (1)             */
+		    0x75, 0x05,		/* report size (5)              */
+		    0x81, 0x01,		/* input (constant)             */
+		    /* relative motion                              */
+		    0x05, 0x01,		/* usage page (generic desktop) */
+		    0x09, 0x30,		/* usage (x)                    */
+		    0x09, 0x31,		/* usage (y)                    */
+		    0x09, 0x38,		/* usage (wheel)                */
+		    0x15, 0x81,		/* logical minimum (-127)       */
+		    0x25, 0x7F,		/* logical maximum (127)        */
+		    0x75, 0x08,		/* report size (8)              */
+		    0x95, 0x03,		/* report count (3)             */
+		    0x81, 0x06,		/* input (data,var,rel)         */
+		  0xC0,				/* end collection               */
+		0xC0				/* end collection               */
+	}
+};
+
+static bool udi_hid_pointer_setreport(void);
+
+static void udi_hid_pointer_report_in_sent(udd_ep_status_t status,
+	                                       iram_size_t     nb_sent,
+	                                       udd_ep_id_t     ep);
+
+/* --------------------------------------------------------------------- */
+
+bool udi_hid_pointer_enable(void) {
+	udi_hid_pointer_rate = 0;
+	udi_hid_pointer_protocol = 0;
+	udi_hid_pointer_b_report_in_free = true;
+
+	UDI_HID_POINTER_ENABLE_EXT();
+	return true;
+}
+
+void udi_hid_pointer_disable(void) {
+	UDI_HID_POINTER_DISABLE_EXT();
+}
+
+bool udi_hid_pointer_setup(void) {
+	return udi_hid_setup(&udi_hid_pointer_rate,
+		                 &udi_hid_pointer_protocol,
+		                (uint8_t *) &udi_hid_pointer_report_desc,
+		                 udi_hid_pointer_setreport);
+}
+
+uint8_t udi_hid_pointer_getsetting(void) {
+	return 0;
+}
+
+static bool udi_hid_pointer_setreport(void)
+{
+	return false;
+}
+
+
+bool udi_hid_pointer_send_report_in(uint8_t *data)
+{
+	if (!udi_hid_pointer_b_report_in_free)
+		return false;
+	irqflags_t flags = cpu_irq_save();
+
+	memcpy(&udi_hid_pointer_report_in,
+		   data,
+		   sizeof(udi_hid_pointer_report_in));
+	udi_hid_pointer_b_report_in_free = !udd_ep_run(UDI_HID_POINTER_EP_IN,
+		                                           false,
+		                                           (uint8_t *) & udi_hid_pointer_report_in,
+		                                           sizeof(udi_hid_pointer_report_in),
+		                                           udi_hid_pointer_report_in_sent);
+	cpu_irq_restore(flags);
+	return !udi_hid_pointer_b_report_in_free;
+}
+
+static void udi_hid_pointer_report_in_sent(udd_ep_status_t status,
+	                                       iram_size_t     nb_sent,
+	                                       udd_ep_id_t     ep) {
+	UNUSED(status);
+	UNUSED(nb_sent);
+	UNUSED(ep);
+	udi_hid_pointer_b_report_in_free = true;
+}
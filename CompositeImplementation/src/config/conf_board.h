@@ -1,4 +1,8 @@
 #ifndef CONF_BOARD_H_INCLUDED
 #define CONF_BOARD_H_INCLUDED
 
+// map the scanned ports onto the virtual ports for single-cycle IN/OUT/SBI/CBI
+// (VPORT0 = PORTF keypad, VPORT1 = PORTB, VPORT2 = PORTC, VPORT3 = PORTD; PORTE stays extended)
+#define CONF_BOARD_IO_VPORT   1
+
 #endif /* CONF_BOARD_H_INCLUDED */
@@ -0,0 +1,30 @@
+#ifndef CONF_GESTURE_H_INCLUDED
+#define CONF_GESTURE_H_INCLUDED
+
+// timing, in ms of scanner ticks
+#define CONFIG_GESTURE_TAP_MS        200   // a touch without travel released within this is a tap
+#define CONFIG_GESTURE_DOUBLE_MS     250   // lift-to-touch gap of a double-tap, 0 sends taps at once
+#define CONFIG_GESTURE_LONG_MS       600   // a touch without travel held this long is a long-press
+#define CONFIG_GESTURE_SWIPE_MS      400   // a stroke must end within this to count as a swipe
+
+// travel, in half-pads, that turns a touch into a stroke
+#define CONFIG_GESTURE_SWIPE_MIN       4
+
+// a swipe taps its key once, plus once per this many pads/s of speed, up to
+// CONFIG_GESTURE_REPEAT_MAX times
+#define CONFIG_GESTURE_SPEED_STEP     40
+#define CONFIG_GESTURE_REPEAT_MAX      3
+
+// keyboard usage sent per gesture, 0 = none (can be changed at runtime through the feature report)
+//   e.g. HID_PAGEDOWN / HID_PAGEUP on the vertical swipes
+#define CONFIG_GESTURE_MAP {                                                    \
+	/* vertical:   tap, double-tap, long-press, swipe down, swipe up     */     \
+	0, 0, 0, 0, 0,                                                              \
+	/* horizontal: tap, double-tap, long-press, swipe left, swipe right  */     \
+	0, 0, 0, 0, 0,                                                              \
+}
+
+// recognized gestures waiting for the USB frame, must be a power of 2
+#define CONFIG_GESTURE_RING_SIZE       8
+
+#endif /* CONF_GESTURE_H_INCLUDED */
@@ -0,0 +1,25 @@
+#ifndef CONF_INPUT_H_INCLUDED
+#define CONF_INPUT_H_INCLUDED
+
+// rate of the TCC0 background scanner sampling the keypad & sliders, in Hz
+#define CONFIG_INPUT_SCAN_HZ     1000
+
+// scanner -> USB event ring depth, must be a power of 2
+#define CONFIG_INPUT_RING_SIZE   32
+
+// debounce window in ms, a switch must hold its new level this long to be accepted
+#define CONFIG_DEBOUNCE_MS       4
+
+// 1: TCC1 -> event channel 0 -> DMA copies the slider ports 8 times per scanner tick into SRAM
+//    rings and each tick majority-votes the batch; 0: the tick reads the slider ports once
+// (the keypad matrix is driven column by column, so it stays on the per-tick scan)
+#define CONFIG_INPUT_DMA         1
+
+// time without any key/pad contact before the scanner stops and pin-change wake takes over, in ms
+#define CONFIG_INPUT_ARM_MS      50
+
+// time each scan in CPU cycles with TCE0 (stats scanCycles / scanCyclesMax), 0 to leave TCE0 off
+// (measurement builds only: it claims TCE0 and reads it twice in every scanner tick)
+#define CONFIG_INPUT_PROFILE     0
+
+#endif /* CONF_INPUT_H_INCLUDED */
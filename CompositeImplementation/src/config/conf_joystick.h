@@ -0,0 +1,27 @@
+#ifndef CONF_JOYSTICK_H_INCLUDED
+#define CONF_JOYSTICK_H_INCLUDED
+
+// axis resolution of the slider reports
+//   0 – one step per pad, 12 positions (legacy)
+//   1 – centroid of the touched run of pads, 23 positions (half-pad steps)
+#define CONFIG_JSTK_INTERPOLATE   1
+
+// axis filter between the pad scan and the report (can be changed at runtime through the feature report)
+//   FILTER_NONE       – raw position, a new report on every pad boundary flicker
+//   FILTER_ALPHA_BETA – position/velocity tracker with fixed gains
+//   FILTER_ONE_EURO   – heavy smoothing at rest, little lag while the finger moves
+#define CONFIG_JSTK_FILTER        FILTER_ONE_EURO
+
+// output holds until the filtered axis moves more than this, in axis units (0-255, half-pad ~11)
+#define CONFIG_JSTK_HYSTERESIS    4
+// axis units either side of center reported as center
+#define CONFIG_JSTK_DEADZONE      0
+
+// filter gains, /256 per 1 ms frame
+#define CONFIG_JSTK_AB_ALPHA       16    // alpha-beta position gain
+#define CONFIG_JSTK_AB_BETA        1     // alpha-beta velocity gain
+#define CONFIG_JSTK_EURO_MINCUTOFF 3     // one-euro smoothing at rest
+#define CONFIG_JSTK_EURO_DCUTOFF   1     // one-euro derivative smoothing
+#define CONFIG_JSTK_EURO_BETA      25    // one-euro cutoff increase with speed
+
+#endif /* CONF_JOYSTICK_H_INCLUDED */
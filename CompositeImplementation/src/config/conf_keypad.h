@@ -0,0 +1,20 @@
+#ifndef CONF_KEYPAD_H_INCLUDED
+#define CONF_KEYPAD_H_INCLUDED
+
+// when key codes go to the host (can be changed at runtime through the feature report)
+//   KEYPAD_REPORT_EDGE    – key-down on the debounced press, key-up on release
+//   KEYPAD_REPORT_RELEASE – down+up together once every key is released (legacy)
+//   KEYPAD_REPORT_NKRO    – every held key in one report per frame, chords included
+//                           (multipress policy unused, ghosted chords are held back)
+#define CONFIG_KEYPAD_REPORT_MODE   KEYPAD_REPORT_NKRO
+
+// what happens while more than one key is held
+//   KEYPAD_MULTI_BLOCK  – the chord is suppressed until every key is released (legacy)
+//   KEYPAD_MULTI_FIRST  – the first key keeps being reported, others are ignored
+//   KEYPAD_MULTI_NEWEST – the newest press replaces the reported key
+#define CONFIG_KEYPAD_MULTIPRESS    KEYPAD_MULTI_BLOCK
+
+// EEPROM address of the keymap override record (KEYPAD_KEYS + 2 bytes)
+#define CONFIG_KEYPAD_KEYMAP_EEPROM 0x0000
+
+#endif /* CONF_KEYPAD_H_INCLUDED */
@@ -0,0 +1,23 @@
+#ifndef CONF_LED_H_INCLUDED
+#define CONF_LED_H_INCLUDED
+
+// startup sequence: every LED + status on, then all off before the panel is handed over.
+// Runs off the 1 ms tick alongside reporting; set both to 0 to skip it.
+#define CONFIG_LED_STARTUP_ON_MS      15000
+#define CONFIG_LED_STARTUP_OFF_MS     2500
+
+// brightness (bam.c): bit k of an LED's 8 bit level is shown for UNIT << k us,
+// one refresh is 255 units (16 us -> 4.08 ms, 245 Hz) and costs 8 interrupts.
+// The unit is timed from sysclk_get_per_hz(), 128 us at most
+#define CONFIG_LED_BAM_UNIT_US        16
+
+// animation scripts (script.c)
+#define CONFIG_LED_SCRIPT_SIZE        48        // bytes in the host-uploaded script slot
+#define CONFIG_LED_SCRIPT_OPS         16        // instructions run per 1 ms tick at most
+#define CONFIG_LED_SCRIPT_DEPTH       2         // nested LOOPs
+
+// EEPROM address of the uploaded script record (CONFIG_LED_SCRIPT_SIZE + 4 bytes),
+// clear of the keymap record at 0x0000
+#define CONFIG_LED_SCRIPT_EEPROM      0x0020
+
+#endif /* CONF_LED_H_INCLUDED */
@@ -0,0 +1,25 @@
+#ifndef CONF_TRACKPAD_H_INCLUDED
+#define CONF_TRACKPAD_H_INCLUDED
+
+// what the sliders drive at power-up (can be changed at runtime through the feature report)
+//   SLIDER_MODE_JOYSTICK – absolute joystick interface
+//   SLIDER_MODE_TRACKPAD – relative pointer interface (horizontal = X, vertical = wheel or Y)
+#define CONFIG_SLIDER_MODE            SLIDER_MODE_JOYSTICK
+
+// 1: vertical slider scrolls (wheel), 0: vertical slider moves the pointer (Y)
+#define CONFIG_TRACKPAD_VERT_WHEEL    1
+
+// counts sent per half-pad of finger travel before acceleration
+#define CONFIG_TRACKPAD_STEP_XY       6     // pointer counts
+#define CONFIG_TRACKPAD_STEP_WHEEL    1     // wheel detents
+
+// acceleration: a half-pad step taken within this many ms counts 4x, within 2x it 2x,
+// within 4x it 1.5x, slower steps 1x
+#define CONFIG_TRACKPAD_FAST_MS       8
+
+// momentum after lift-off
+#define CONFIG_TRACKPAD_LIFT_MS       40    // no coasting if the finger rested this long before lifting
+#define CONFIG_TRACKPAD_FRICTION      240   // velocity kept per ms, /256
+#define CONFIG_TRACKPAD_VEL_MAX       32    // coasting speed limit, counts per ms
+
+#endif /* CONF_TRACKPAD_H_INCLUDED */
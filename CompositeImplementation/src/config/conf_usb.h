@@ -82,8 +82,12 @@
 /* ------------------------- USB Configurations ------------------------- */
 /* ---------------------------------------------------------------------- */
 #define  USB_DEVICE_EP_CTRL_SIZE                 8
-#define  USB_DEVICE_NB_INTERFACE                 3 // total # of interfaces
-#define  USB_DEVICE_MAX_EP                       4
+
+// 1: add the touch digitizer interface (both sliders as one absolute surface), 0: leave it out
+#define  UDI_HID_DIGITIZER                       0
+
+#define  USB_DEVICE_NB_INTERFACE                (5 + UDI_HID_DIGITIZER) // total # of interfaces
+#define  USB_DEVICE_MAX_EP                      (6 + UDI_HID_DIGITIZER)
 
 
 /* ---------------------------------------------------------------------- */
@@ -92,6 +96,10 @@
 #define  UDI_HID_KBD_ENABLE_EXT()           main_kbd_enable()
 #define  UDI_HID_KBD_DISABLE_EXT()          main_kbd_disable()
 // #define  UDI_HID_KBD_CHANGE_LED(value)      BD76319_ui_kbd_led(value)
+#define  UDI_HID_KBD_QUEUE_OVERFLOW()       stats_kbdOverflow()
+#define  UDI_HID_KBD_QUEUE_DEPTH(depth)     stats_kbdQueued(depth)
+
+#define  UDI_HID_KBD_QUEUE_SIZE                  8
 
 #define  UDI_HID_KBD_EP_IN                      (1 | USB_EP_DIR_IN)
 #define  UDI_HID_KBD_IFACE_NUMBER                0
@@ -103,7 +111,14 @@
 #define  UDI_HID_JOYSTICK_ENABLE_EXT()       main_joystick_enable()
 #define  UDI_HID_JOYSTICK_DISABLE_EXT()      main_joystick_disable()
 
+// 1: 16 bit x/y, contact flag per axis & USB frame number (7 bytes), 0: legacy 8 bit x/y (2 bytes)
+#define  UDI_HID_JSTK_HIRES                      1
+
+#if UDI_HID_JSTK_HIRES
+#define  UDI_HID_JSTK_REPORT_IN_SIZE             7
+#else
 #define  UDI_HID_JSTK_REPORT_IN_SIZE             2
+#endif
 #define  UDI_HID_JSTK_REPORT_OUT_SIZE            0
 #define  UDI_HID_JSTK_REPORT_FEATURE_SIZE        0
 #define  UDI_HID_JSTK_EP_SIZE                    8
@@ -117,38 +132,108 @@
 #define UDI_HID_LED_ENABLE_EXT()            main_led_enable()
 #define UDI_HID_LED_DISABLE_EXT()           main_led_disable()
 #define UDI_HID_LED_REPORT_OUT(ptr)         led_ui_report(ptr)
+#define UDI_HID_LED_GET_FEATURE(ptr)        feature_ui_get(ptr)
+#define UDI_HID_LED_SET_FEATURE(ptr)        feature_ui_set(ptr)
 
 #define UDI_HID_LED_REPORT_IN_SIZE               7
 #define UDI_HID_LED_REPORT_OUT_SIZE              2
-#define UDI_HID_LED_REPORT_FEATURE_SIZE          0
+#define UDI_HID_LED_REPORT_FEATURE_SIZE         64
 #define UDI_HID_LED_EP_SIZE                      8
 
 #define UDI_HID_LED_EP_IN                       (4 | USB_EP_DIR_IN)
 #define UDI_HID_LED_EP_OUT                      (3 | USB_EP_DIR_OUT)
 #define UDI_HID_LED_IFACE_NUMBER                 2
 
+/* ---------------------------------------------------------------------- */
+/* ------------------  HID-POINTER interface settings ------------------- */
+/* ---------------------------------------------------------------------- */
+#define UDI_HID_POINTER_ENABLE_EXT()        main_pointer_enable()
+#define UDI_HID_POINTER_DISABLE_EXT()       main_pointer_disable()
+
+// buttons, x, y, wheel
+#define UDI_HID_POINTER_REPORT_IN_SIZE           4
+#define UDI_HID_POINTER_EP_SIZE                  8
+
+#define UDI_HID_POINTER_EP_IN                   (5 | USB_EP_DIR_IN)
+#define UDI_HID_POINTER_IFACE_NUMBER             3
+
+/* ---------------------------------------------------------------------- */
+/* -------------------  HID-EVENT interface settings -------------------- */
+/* ---------------------------------------------------------------------- */
+#define UDI_HID_EVENT_ENABLE_EXT()          main_event_enable()
+#define UDI_HID_EVENT_DISABLE_EXT()         main_event_disable()
+
+// source, switch, sequence, dropped, transition time, frame time (see events.c)
+#define UDI_HID_EVENT_REPORT_IN_SIZE            12
+#define UDI_HID_EVENT_EP_SIZE                   16
+
+#define UDI_HID_EVENT_EP_IN                     (6 | USB_EP_DIR_IN)
+#define UDI_HID_EVENT_IFACE_NUMBER               4
+
+/* ---------------------------------------------------------------------- */
+/* -----------------  HID-DIGITIZER interface settings ------------------ */
+/* ---------------------------------------------------------------------- */
+#define UDI_HID_DIGITIZER_ENABLE_EXT()      main_digitizer_enable()
+#define UDI_HID_DIGITIZER_DISABLE_EXT()     main_digitizer_disable()
+
+#define UDI_HID_DIGITIZER_ID_INPUT               1
+#define UDI_HID_DIGITIZER_ID_FEATURE             2
+
+// id, tip/in range, contact id, x, y, contact count
+#define UDI_HID_DIGITIZER_REPORT_IN_SIZE         8
+#define UDI_HID_DIGITIZER_EP_SIZE                8
+
+// active length of the horizontal & vertical slider, the host maps the surface by it
+#define UDI_HID_DIGITIZER_WIDTH_MM              60
+#define UDI_HID_DIGITIZER_HEIGHT_MM             60
+
+#define UDI_HID_DIGITIZER_EP_IN                 (7 | USB_EP_DIR_IN)
+#define UDI_HID_DIGITIZER_IFACE_NUMBER           5
+
 /* ---------------------------------------------------------------------- */
 /* ------------------------  HID-COMPOSITE stuff ------------------------ */
 /* ---------------------------------------------------------------------- */
+#if UDI_HID_DIGITIZER
+#define UDI_COMPOSITE_DIGITIZER_T   udi_hid_digitizer_desc_t udi_hid_digitizer;
+#define UDI_COMPOSITE_DIGITIZER     , .udi_hid_digitizer = UDI_HID_DIGITIZER_DESC
+#define UDI_COMPOSITE_DIGITIZER_API , &udi_api_hid_digitizer
+#else
+#define UDI_COMPOSITE_DIGITIZER_T
+#define UDI_COMPOSITE_DIGITIZER
+#define UDI_COMPOSITE_DIGITIZER_API
+#endif
+
 #define UDI_COMPOSITE_DESC_T                           \
 		udi_hid_kbd_desc_t      udi_hid_kbd;           \
 		udi_hid_joystick_desc_t udi_hid_joystick;      \
-		udi_hid_led_desc_t      udi_hid_led;
+		udi_hid_led_desc_t      udi_hid_led;           \
+		udi_hid_pointer_desc_t  udi_hid_pointer;       \
+		udi_hid_event_desc_t    udi_hid_event;         \
+		UDI_COMPOSITE_DIGITIZER_T
 
 #define UDI_COMPOSITE_DESC_FS                          \
 		.udi_hid_kbd       =    UDI_HID_KBD_DESC,      \
 		.udi_hid_joystick  =    UDI_HID_JOYSTICK_DESC, \
-		.udi_hid_led       =    UDI_HID_LED_DESC
+		.udi_hid_led       =    UDI_HID_LED_DESC,      \
+		.udi_hid_pointer   =    UDI_HID_POINTER_DESC,  \
+		.udi_hid_event     =    UDI_HID_EVENT_DESC     \
+		UDI_COMPOSITE_DIGITIZER
 
 #define UDI_COMPOSITE_DESC_HS                          \
 		.udi_hid_kbd       =    UDI_HID_KBD_DESC,      \
 		.udi_hid_joystick  =    UDI_HID_JOYSTICK_DESC, \
-		.udi_hid_led       =    UDI_HID_LED_DESC
+		.udi_hid_led       =    UDI_HID_LED_DESC,      \
+		.udi_hid_pointer   =    UDI_HID_POINTER_DESC,  \
+		.udi_hid_event     =    UDI_HID_EVENT_DESC     \
+		UDI_COMPOSITE_DIGITIZER
 
 #define UDI_COMPOSITE_API                              \
 		&udi_api_hid_kbd,                              \
 		&udi_api_hid_joystick,                         \
-		&udi_api_hid_led
+		&udi_api_hid_led,                              \
+		&udi_api_hid_pointer,                          \
+		&udi_api_hid_event                             \
+		UDI_COMPOSITE_DIGITIZER_API
 
 
 /* ---------------------------------------------------------------------- */
@@ -157,9 +242,13 @@
 #include "udi_hid_kbd.h"
 #include "udi_hid_joystick.h"
 #include "udi_hid_led.h"
+#include "udi_hid_pointer.h"
+#include "udi_hid_event.h"
+#include "udi_hid_digitizer.h"
 
 #include "main.h"
 #include "ui.h"
+#include "stats.h"
 
 
 #endif // _CONF_USB_H_
@@ -6,8 +6,9 @@
  *   • Initialize vector table, CPU interrupts, sleep manager, and system clock  
  *   • Configure front-panel I/O and sub-devices (LEDs, keypad, joystick)  
  *   • Start the USB device controller and run the startup LED sequence  
- *   • On USB Start-of-Frame callbacks, service keyboard, joystick, and GUI LED reports when configured  
+ *   • On USB Start-of-Frame callbacks, drain scanner events and service keyboard, joystick, pointer, digitizer, event, and GUI LED reports when configured  
  *   • Fallback while-loop to process keyboard, joystick, and status LED blinking w/o a USB connection
+ *   • Sleep between events, deeper than IDLE while the scanner is armed for pin-change wake
  *
  * History:
  *   Created June 3, 2025
@@ -15,13 +16,21 @@
 
 #include <asf.h>
 #include "conf_usb.h"
-#include <util/delay.h>
 
 #include "modules/ui.h"
+#include "modules/input.h"
+#include "modules/keypad.h"
+#include "modules/script.h"
 
 static volatile bool main_b_kbd_enable  = false;
 static volatile bool main_b_jstk_enable = false;
 static volatile bool main_b_led_enable  = false;
+static volatile bool main_b_ptr_enable  = false;
+static volatile bool main_b_evt_enable  = false;
+static volatile bool main_b_digi_enable = false;
+
+#define MAIN_SOF_QUIET  2                        // scanner ticks without a SOF before the loop takes over
+static volatile uint8_t main_sofTick;            // scanner tick of the last SOF
 
 int main (void)
 {
@@ -37,22 +46,42 @@ int main (void)
 	// initializes i/o pins & sub-devices
 	io_ui_process();
 
+	// no SOF yet, the while-loop steps the LEDs until one arrives
+	main_sofTick = input_getTicks() - MAIN_SOF_QUIET - 1;
+
 	// starts USB device controller
 	udc_start();
 
-	// startup sequence (blocking)
-	startup_ui_process();
+	// startup sequence, stepped from the 1 ms tick below so reporting starts right away
+	startup_ui_start();
 
 	// while-loop driven operation
 	// *for testing w/o a USB connection*
+	uint8_t tick = input_getTicks();
 	while (true) {
+		keypad_eepromTask(); // keymap written by the host, too slow for the interrupt
+		script_eepromTask(); // LED script saved by the host, same
+
 		if (udc_is_configured()) { // usb?
 			sleepmgr_enter_sleep(); // shutoff
 		} else if ((PORTB.IN & PIN4_bm) == 0) {
+			if (input_getTicks() == tick) {
+				sleepmgr_enter_sleep(); // until the next scanner tick
+				continue;
+			}
+			tick = input_getTicks();
+
+			// attached but not configured, SOFs already step the LEDs: only one context may
+			if ((uint8_t)(tick - main_sofTick) > MAIN_SOF_QUIET) {
+				startup_ui_process( );
+				fade_ui_process   ( );
+			}
+			input_ui_process  ( );
 			kbd_ui_process    ( );
 			jstk_ui_process   ( );
 			status_ui_process (0);
-			_delay_ms         (1);
+		} else {
+			sleepmgr_enter_sleep(); // until USB or a touch wakes us
 		}
 	}
 }
@@ -67,13 +96,25 @@ void main_resume_action(void) { }
 // SoF driven operation
 // *for normal use*
 void main_sof_action(void) {
+	main_sofTick = input_getTicks(); // keeps the while-loop off the LED steps below
+	evt_ui_sof       ( ); // frame start time for the event reports
+	startup_ui_process( ); // startup LED sequence
+	fade_ui_process  ( ); // LED fades
 	if (!main_b_kbd_enable)
 		return;
+	input_frame      ( ); // armed/scanning residency
+	input_ui_process ( ); // drain scanner events
 	kbd_ui_process   ( ); // keypad logic
 
 	if (!main_b_jstk_enable)
 		return;
 	jstk_ui_process  ( ); // joystick logic
+	if (main_b_ptr_enable)
+		ptr_ui_process   ( ); // trackpad logic
+	if (main_b_digi_enable)
+		digi_ui_process  ( ); // touch surface logic
+	if (main_b_evt_enable)
+		evt_ui_process   ( ); // timestamped transitions
 
 	if (!main_b_led_enable)
 		return;
@@ -120,4 +161,42 @@ bool main_led_enable(void) {
 }
 void main_led_disable(void) {
 	main_b_led_enable = false;
+}
+
+
+/* ------------------------------------------ */
+/* ---------------- pointer ----------------- */
+/* ------------------------------------------ */
+bool main_pointer_enable(void) {
+	main_b_ptr_enable = true;
+	return true;
+}
+void main_pointer_disable(void) {
+	main_b_ptr_enable = false;
+}
+
+
+/* ------------------------------------------ */
+/* --------------- digitizer ---------------- */
+/* ------------------------------------------ */
+bool main_digitizer_enable(void) {
+	main_b_digi_enable = true;
+	return true;
+}
+void main_digitizer_disable(void) {
+	main_b_digi_enable = false;
+}
+
+
+/* ------------------------------------------ */
+/* ----------------- events ----------------- */
+/* ------------------------------------------ */
+bool main_event_enable(void) {
+	main_b_evt_enable = true;
+	evt_ui_enable(true);
+	return true;
+}
+void main_event_disable(void) {
+	main_b_evt_enable = false;
+	evt_ui_enable(false);
 }
\ No newline at end of file
@@ -23,5 +23,17 @@ void main_joystick_disable(void);
 bool main_led_enable(void);
 void main_led_disable(void);
 
+/* ------------ pointer ------------ */
+bool main_pointer_enable(void);
+void main_pointer_disable(void);
+
+/* ----------- digitizer ----------- */
+bool main_digitizer_enable(void);
+void main_digitizer_disable(void);
+
+/* ------------- events ------------ */
+bool main_event_enable(void);
+void main_event_disable(void);
+
 
 #endif
\ No newline at end of file
@@ -0,0 +1,115 @@
+/*
+ * bam.c – Bit-angle-modulated LED brightness for the EVi Classic firmware
+ *
+ * Purpose: Give the 8 PORTA LEDs and the status LED 8 bit brightness without timer compare
+ *          outputs: TCE1 splits each refresh into 8 intervals of 1, 2, 4 .. 128 units and shows
+ *          bit plane k of the levels during interval k. While every LED is fully on or off the
+ *          timer stops and the pins are driven directly, so plain on/off costs no interrupts.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include "conf_led.h"
+
+#include "led.h"
+#include "bam.h"
+
+#define BAM_BITS       8
+#define BAM_UNIT       ((uint16_t)((uint32_t)CONFIG_LED_BAM_UNIT_US * (sysclk_get_per_hz() / 8) / 1000000UL))
+#define BAM_PER(bit)   ((BAM_UNIT << (bit)) - 1)   // TCE1 at clk_per / 8, 1.5 MHz from conf_clock.h
+
+#if (CONFIG_LED_BAM_UNIT_US << (BAM_BITS - 1)) > 0x10000 / 4
+#  error CONFIG_LED_BAM_UNIT_US too long for a 16 bit period (at clk_per up to 32 MHz)
+#endif
+
+// bit planes in the LED shadow layout (bits 0-7 LED1-8, bit 8 status), word k is interval k
+static uint16_t         bam_work[BAM_BITS];           // edited by bam_setMask()
+static uint16_t         bam_plane[BAM_BITS];          // shown by the interrupt
+static uint16_t         bam_nextPlane[BAM_BITS];      // latched at the start of a refresh
+static volatile bool    bam_pending;
+static volatile uint8_t bam_bit;                      // interval being shown
+static bool             bam_running;
+
+
+static inline void bam_show(uint16_t on) { // LEDs are active low, all eight in one store
+	LED_PORT.OUT = (LED_PORT.OUT & ~LED_MASK) | (~on & LED_MASK);
+	if (on & BAM_STATUS)
+		STATUS_LED_PORT.OUTCLR = LEDS_PIN;
+	else
+		STATUS_LED_PORT.OUTSET = LEDS_PIN;
+}
+
+void bam_init(void) {
+	sysclk_enable_module(SYSCLK_PORT_E, SYSCLK_TC1);
+
+	TCE1.CTRLA    = TC_CLKSEL_OFF_gc;
+	TCE1.CTRLB    = TC_WGMODE_NORMAL_gc;
+	TCE1.INTCTRLA = TC_OVFINTLVL_MED_gc;  // above USB & scanner, so the short intervals stay short
+	bam_show(0);
+}
+
+// level of the LEDs in mask, shown after the next bam_update()
+void bam_setMask(uint16_t mask, uint8_t level) {
+	for (uint8_t k = 0; k < BAM_BITS; k++, level >>= 1)
+		bam_work[k] = (level & 1) ? (bam_work[k] | mask) : (bam_work[k] & ~mask);
+}
+
+// commits the planes, the timer runs only while some level is between off and full
+void bam_update(void) {
+	bool    dim = false;
+	uint8_t k;
+
+	for (k = 1; k < BAM_BITS; k++)
+		dim |= (bam_work[k] != bam_work[0]);
+
+	irqflags_t flags = cpu_irq_save();
+	if (!dim) {
+		if (bam_running) {
+			TCE1.CTRLA  = TC_CLKSEL_OFF_gc;
+			bam_running = false;
+			bam_pending = false;
+			sleepmgr_unlock_mode(SLEEPMGR_IDLE);
+		}
+		bam_show(bam_work[0]);
+	} else if (bam_running) {                 // swap in at the next refresh, no torn frame
+		for (k = 0; k < BAM_BITS; k++)
+			bam_nextPlane[k] = bam_work[k];
+		bam_pending = true;
+	} else {
+		for (k = 0; k < BAM_BITS; k++)
+			bam_plane[k] = bam_work[k];
+		bam_bit     = 0;
+		bam_show(bam_plane[0]);
+		TCE1.CNT    = 0;
+		TCE1.PER    = BAM_PER(0);
+		TCE1.PERBUF = BAM_PER(1);             // loaded at the end of interval 0
+		TCE1.CTRLA  = TC_CLKSEL_DIV8_gc;      // BAM_UNIT counts per unit
+		bam_running = true;
+		sleepmgr_lock_mode(SLEEPMGR_IDLE);    // TCE1 needs clk_per
+	}
+	cpu_irq_restore(flags);
+}
+
+bool bam_isDim(void) {
+	return bam_running;
+}
+
+// end of an interval: PER already holds this one's length (from PERBUF), queue the next one's
+// first, the interval just started may be a single unit. pending planes are copied inside the
+// longest interval and shown from the next bit 0 on
+ISR(TCE1_OVF_vect) {
+	uint8_t bit = (bam_bit + 1) & (BAM_BITS - 1);
+	uint8_t k;
+
+	TCE1.PERBUF = BAM_PER((bit + 1) & (BAM_BITS - 1));
+	bam_show(bam_plane[bit]);
+	bam_bit     = bit;
+
+	if (bit == BAM_BITS - 1 && bam_pending) {
+		for (k = 0; k < BAM_BITS; k++)
+			bam_plane[k] = bam_nextPlane[k];
+		bam_pending = false;
+	}
+}
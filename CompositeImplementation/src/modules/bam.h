@@ -0,0 +1,15 @@
+#ifndef BAM_H
+#define BAM_H
+
+
+#define BAM_LEDS         9          // LED1-8 on PORTA (bits 0-7), status LED (bit 8)
+#define BAM_STATUS       (1u << 8)  // status LED in a BAM mask
+#define BAM_FULL         255
+
+void    bam_init    (void);
+void    bam_setMask (uint16_t mask, uint8_t level);
+void    bam_update  (void);
+bool    bam_isDim   (void);
+
+
+#endif
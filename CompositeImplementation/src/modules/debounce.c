@@ -0,0 +1,41 @@
+/*
+ * debounce.c – Bit-parallel switch debouncing for the EVi Classic firmware
+ *
+ * Purpose: Filter up to 32 switches at once with a 2-bit vertical counter per switch.
+ *          A switch only changes state after 4 consecutive samples disagree with it,
+ *          and samples are spaced so those 4 samples span CONFIG_DEBOUNCE_MS.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include "conf_input.h"
+
+#include "debounce.h"
+
+
+void debounce_init(debounce_t *db) {
+	db->state = 0;
+	db->cnt0  = 0;
+	db->cnt1  = 0;
+	db->div   = 0;
+}
+
+/*
+ * feeds one raw sample (1 = pressed) and returns the bits that changed state
+ */
+uint32_t debounce_update(debounce_t *db, uint32_t sample)
+{
+	if (++db->div < DEBOUNCE_SAMPLE_TICKS)
+		return 0;
+	db->div = 0;
+
+	uint32_t delta = sample ^ db->state;         // switches that disagree with state
+	db->cnt1 = (db->cnt1 ^ db->cnt0) & delta;    // count up, reset where they agree
+	db->cnt0 = ~db->cnt0 & delta;
+	uint32_t toggle = delta & ~(db->cnt0 | db->cnt1); // counter rolled over (4 samples)
+	db->state ^= toggle;
+
+	return toggle;
+}
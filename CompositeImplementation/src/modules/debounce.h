@@ -0,0 +1,28 @@
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+
+#include "conf_input.h"
+
+// scanner ticks between samples so that 4 samples cover the debounce window
+#define DEBOUNCE_DIV  (CONFIG_DEBOUNCE_MS * 1L * CONFIG_INPUT_SCAN_HZ / 4000)
+#if DEBOUNCE_DIV > 1
+#  define DEBOUNCE_SAMPLE_TICKS  DEBOUNCE_DIV
+#else
+#  define DEBOUNCE_SAMPLE_TICKS  1
+#endif
+
+// a clean edge is accepted on its 4th sample, this many ticks after it was first seen
+#define DEBOUNCE_LAG_TICKS     (3 * DEBOUNCE_SAMPLE_TICKS)
+
+typedef struct {
+	uint32_t state;  // debounced state, 1 = pressed
+	uint32_t cnt0;   // vertical counter, low bit of each switch
+	uint32_t cnt1;   // vertical counter, high bit of each switch
+	uint8_t  div;    // tick prescaler for the debounce window
+} debounce_t;
+
+void     debounce_init   (debounce_t *db);
+uint32_t debounce_update (debounce_t *db, uint32_t sample);
+
+
+#endif
@@ -0,0 +1,76 @@
+/*
+ * digitizer.c – Absolute touch surface for the EVi Classic firmware
+ *
+ * Purpose: Combine the horizontal (X) and vertical (Y) slider into one absolute single-contact
+ *          surface, smooth each axis through the filter stage and send tip, contact id and
+ *          position on the digitizer interface whenever they change.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include <string.h>
+
+#include "input.h"
+#include "filter.h"
+#include "digitizer.h"
+
+#define DIGI_X          0
+#define DIGI_Y          1
+#define DIGI_POS_MAX    22      // half-pad positions per slider (0-22)
+#define DIGI_LOGICAL    0x7FFF  // logical maximum of x & y in the report descriptor
+
+#define DIGI_TIP        (1u << 0)
+#define DIGI_IN_RANGE   (1u << 1)
+
+static filter_t digi_filter[2];
+static uint16_t digi_pos[2]   = { DIGI_LOGICAL / 2, DIGI_LOGICAL / 2 }; // held while the slider is lifted
+static uint8_t  digi_contact;                   // contact id, new one per touch-down
+static bool     digi_tip;
+static uint8_t  digi_usbReport[UDI_HID_DIGITIZER_REPORT_IN_SIZE];
+static uint8_t  digi_prevReport[UDI_HID_DIGITIZER_REPORT_IN_SIZE];
+
+
+static void digi_axis(uint8_t axis, int8_t pos) {
+	uint16_t out;
+
+	out = filter_update(&digi_filter[axis], (uint8_t)((uint16_t)pos * 255 / DIGI_POS_MAX), pos >= 0);
+	if (pos < 0)                                // keep the last point of a lifted slider
+		return;
+	out += out >> 8;                            // 0-255.0 -> 0-65535
+	digi_pos[axis] = out >> 1;
+}
+
+void digitizer_usbTask(void) // build and send 8 byte report
+{
+	input_snapshot_t const *snap = input_getSnapshot();
+	bool tip = (snap->horiPos >= 0) || (snap->vertPos >= 0);
+
+	digi_axis(DIGI_X, snap->horiPos);
+	digi_axis(DIGI_Y, snap->vertPos);
+
+	if (tip && !digi_tip)
+		digi_contact = (digi_contact + 1) & 0x7F;
+	digi_tip = tip;
+
+	// pads count up/right (see jstk_ledMask), HID Y grows downward
+	uint16_t y = DIGI_LOGICAL - digi_pos[DIGI_Y];
+
+	digi_usbReport[0] = UDI_HID_DIGITIZER_ID_INPUT;
+	digi_usbReport[1] = tip ? (DIGI_TIP | DIGI_IN_RANGE) : 0;
+	digi_usbReport[2] = digi_contact;
+	digi_usbReport[3] = (uint8_t)digi_pos[DIGI_X];
+	digi_usbReport[4] = (uint8_t)(digi_pos[DIGI_X] >> 8);
+	digi_usbReport[5] = (uint8_t)y;
+	digi_usbReport[6] = (uint8_t)(y >> 8);
+	digi_usbReport[7] = tip ? 1 : 0;                            // contact count
+
+	// send if changed & IN endpoint ready, a lift goes out once with the last point
+	if (memcmp(digi_usbReport, digi_prevReport, sizeof(digi_prevReport))) {
+		if (udi_hid_digitizer_send_report_in(digi_usbReport)) {  // IN endpoint ready?
+			memcpy(digi_prevReport, digi_usbReport, sizeof(digi_prevReport));
+			input_reportSent();
+		}
+	}
+}
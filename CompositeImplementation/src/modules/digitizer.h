@@ -0,0 +1,8 @@
+#ifndef DIGITIZER_H
+#define DIGITIZER_H
+
+
+void digitizer_usbTask (void);
+
+
+#endif
@@ -0,0 +1,94 @@
+/*
+ * events.c – Timestamped input transitions for the event interface of the EVi Classic firmware
+ *
+ * Purpose: Queue every keypad and slider transition drained from the scanner, with the time it
+ *          was first sampled, and send them one per frame on the event interface, together with
+ *          the time of the USB frame they left in, for latency and slider velocity measurement.
+ *
+ * Report (UDI_HID_EVENT_REPORT_IN_SIZE bytes, little endian):
+ *   0     source (INPUT_SRC_*), bit 7 set on press
+ *   1     switch (keypad matrix bit or slider pad)
+ *   2     sequence number (wraps)
+ *   3     transitions dropped since the previous report (255 max)
+ *   4-7   transition time, us (timebase)
+ *   8-11  start of the USB frame the report was queued in, us (timebase)
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include <string.h>
+#include "conf_usb.h"
+
+#include "events.h"
+#include "timebase.h"
+#include "stats.h"
+
+#define EVENTS_QUEUE_SIZE  16
+#define EVENTS_QUEUE_MASK  (EVENTS_QUEUE_SIZE - 1)
+
+static input_event_t evt_queue[EVENTS_QUEUE_SIZE];
+static uint8_t       evt_head;          // producer and consumer both run in the SOF handler
+static uint8_t       evt_tail;
+static uint8_t       evt_seq;
+static uint8_t       evt_dropped;
+static bool          evt_enabled;
+static uint32_t      evt_sofTime;
+
+static uint8_t       evt_usbReport[UDI_HID_EVENT_REPORT_IN_SIZE];
+
+
+void events_enable(bool on) {
+	evt_enabled = on;
+	evt_head    = evt_tail;             // nothing stale from before the host was listening
+}
+
+void events_push(input_event_t const *ev) {
+	uint8_t next = (evt_head + 1) & EVENTS_QUEUE_MASK;
+
+	if (!evt_enabled)
+		return;
+	if (next == evt_tail) {             // host not reading, keep the oldest and count the loss
+		if (evt_dropped < 255)
+			evt_dropped++;
+		stats.evtDropped++;
+		return;
+	}
+	evt_queue[evt_head] = *ev;
+	evt_head = next;
+}
+
+void events_sof(void) {
+	evt_sofTime = timebase_now();
+}
+
+static void evt_put32(uint8_t *p, uint32_t v) {
+	p[0] = (uint8_t)v;
+	p[1] = (uint8_t)(v >> 8);
+	p[2] = (uint8_t)(v >> 16);
+	p[3] = (uint8_t)(v >> 24);
+}
+
+void events_usbTask(void) // send the oldest queued transition, if the endpoint is free
+{
+	input_event_t const *ev;
+
+	if (evt_tail == evt_head)
+		return;
+	ev = &evt_queue[evt_tail];
+
+	evt_usbReport[0] = ev->src | (ev->pressed ? 0x80 : 0);
+	evt_usbReport[1] = ev->bit;
+	evt_usbReport[2] = evt_seq;
+	evt_usbReport[3] = evt_dropped;
+	evt_put32(&evt_usbReport[4], ev->time);
+	evt_put32(&evt_usbReport[8], evt_sofTime);
+
+	if (udi_hid_event_send_report_in(evt_usbReport)) {   // IN endpoint ready?
+		evt_tail    = (evt_tail + 1) & EVENTS_QUEUE_MASK;
+		evt_seq++;
+		evt_dropped = 0;
+		stats.evtSent++;
+	}
+}
@@ -0,0 +1,12 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include "input.h"
+
+void events_enable  (bool on);
+void events_push    (input_event_t const *ev);
+void events_sof     (void);
+void events_usbTask (void);
+
+
+#endif
@@ -0,0 +1,203 @@
+/*
+ * fade.c – Gamma-corrected LED fades for the EVi Classic firmware
+ *
+ * Purpose: Ramp LED brightness over time (fade in/out, crossfade between masks, breathing) in
+ *          perceived steps, one fixed-point add per LED per ms tick, and map the result through
+ *          a flash gamma table onto the linear BAM levels.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+
+#include "bam.h"
+#include "fade.h"
+
+#define FADE_RAMP     0       // heading for a level, then still
+#define FADE_BREATHE  1       // bouncing between off and full
+
+#define FADE_TOP      ((uint16_t)FADE_FULL << 8)
+#define FADE_STEP_MAX 0x7FFF
+#define FADE_ALL      ((1u << BAM_LEDS) - 1)
+
+typedef struct {
+	uint16_t pos;     // perceived brightness, 8.8
+	uint16_t end;     // where the ramp stops, 8.8
+	int16_t  step;    // change per ms, 8.8
+	uint8_t  mode;    // while moving
+	uint8_t  shown;   // linear level handed to the BAM
+} fade_t;
+
+static fade_t   fade_led[BAM_LEDS];
+static uint16_t fade_moving;          // LEDs with a fade running, same bits as the masks
+
+// perceived -> linear duty, gamma 2.2, anything above 0 stays at least 1 so a dim LED is still lit
+static PROGMEM_DECLARE(uint8_t, fade_gamma[256]) = {
+	  0,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,   1,
+	  1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+	  3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+	  6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+	 12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+	 20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+	 30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+	 42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+	 56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+	 73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+	 91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+	113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+	137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+	163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+	192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+	223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+};
+
+
+#define FADE_LINEAR(level)  PROGMEM_READ_BYTE(&fade_gamma[level])   // perceived -> BAM level
+#define FADE_GAMMA(pos)     FADE_LINEAR((pos) >> 8)                 // same, from 8.8
+
+static void fade_show(uint8_t led) {
+	fade_led[led].shown = FADE_GAMMA(fade_led[led].pos);
+	bam_setMask(1u << led, fade_led[led].shown);
+}
+
+// the only divisions: the per-ms step, once when a fade starts
+static int16_t fade_rate(int32_t delta, uint16_t ms) {
+	int32_t step = delta / ms;
+
+	if (step == 0)             step = (delta > 0) ? 1 : -1;
+	if (step >  FADE_STEP_MAX) step =  FADE_STEP_MAX;
+	if (step < -FADE_STEP_MAX) step = -FADE_STEP_MAX;
+	return (int16_t)step;
+}
+
+static void fade_start(uint8_t led, uint8_t level, uint16_t ms) {
+	fade_t *f     = &fade_led[led];
+	int32_t delta = ((int32_t)level << 8) - f->pos;
+
+	f->end = (uint16_t)level << 8;
+	if (!ms || !delta) {
+		f->pos = f->end;
+		fade_moving &= ~(1u << led);
+		fade_show(led);
+		return;
+	}
+	f->step = fade_rate(delta, ms);
+	f->mode = FADE_RAMP;
+	fade_moving |= (1u << led);
+}
+
+// stops the fades in mask and records where they stand
+static void fade_hold(uint16_t mask, uint8_t level) {
+	uint8_t shown = FADE_LINEAR(level);
+
+	mask        &= FADE_ALL;
+	fade_moving &= ~mask;
+	for (uint8_t i = 0; mask; i++, mask >>= 1) {
+		if (mask & 1) {
+			fade_led[i].pos   = (uint16_t)level << 8;
+			fade_led[i].shown = shown;
+		}
+	}
+}
+
+
+// jump to level (perceived, 0-255) and stop any fade, mask bit 8 = status LED
+void fade_set(uint16_t mask, uint8_t level) {
+	fade_hold(mask, level);
+	bam_setMask(mask, FADE_LINEAR(level));
+	bam_update();
+}
+
+// LEDs in mask to full if their bit in on is set, off otherwise, in one commit
+void fade_setMask(uint16_t mask, uint16_t on) {
+	fade_hold(mask &  on, FADE_FULL);
+	fade_hold(mask & ~on, 0);
+	bam_setMask(mask &  on, BAM_FULL);
+	bam_setMask(mask & ~on, 0);
+	bam_update();
+}
+
+void fade_to(uint16_t mask, uint8_t level, uint16_t ms) {
+	for (uint8_t i = 0; i < BAM_LEDS; i++)
+		if (mask & (1u << i))
+			fade_start(i, level, ms);
+	bam_update();
+}
+
+void fade_in(uint16_t mask, uint16_t ms) {
+	fade_to(mask, FADE_FULL, ms);
+}
+
+void fade_out(uint16_t mask, uint16_t ms) {
+	fade_to(mask, 0, ms);
+}
+
+// from goes dark while to comes up, LEDs in both just come up
+void fade_cross(uint16_t from, uint16_t to, uint16_t ms) {
+	fade_to(from & ~to, 0, ms);
+	fade_to(to, FADE_FULL, ms);
+}
+
+// off -> full -> off once per period, starting from the current level
+void fade_breathe(uint16_t mask, uint16_t periodMs) {
+	uint16_t half = (periodMs > 1) ? periodMs / 2 : 1;
+	int16_t  step = fade_rate(FADE_TOP, half);
+
+	for (uint8_t i = 0; i < BAM_LEDS; i++) {
+		if (mask & (1u << i)) {
+			fade_t *f = &fade_led[i];
+			bool    up = (f->pos < FADE_TOP);
+
+			f->end  = up ? FADE_TOP : 0;
+			f->step = up ? step : -step;
+			f->mode = FADE_BREATHE;
+		}
+	}
+	fade_moving |= mask & FADE_ALL;
+}
+
+
+// 1 ms: one add per moving LED, the planes are committed only if a level changed
+void fade_tick(void) {
+	uint16_t moving = fade_moving;
+	bool     dirty  = false;
+
+	for (uint8_t i = 0; moving; i++, moving >>= 1) {
+		fade_t *f = &fade_led[i];
+		int32_t pos;
+		uint8_t level;
+
+		if (!(moving & 1))
+			continue;
+
+		pos = (int32_t)f->pos + f->step;
+		if ((f->step > 0) ? (pos >= f->end) : (pos <= f->end)) {
+			pos = f->end;
+			if (f->mode == FADE_BREATHE) {      // turn around, same speed back
+				f->end  = f->end ? 0 : FADE_TOP;
+				f->step = -f->step;
+			} else {
+				fade_moving &= ~(1u << i);
+			}
+		}
+		f->pos = (uint16_t)pos;
+
+		level = FADE_GAMMA(f->pos);
+		if (level != f->shown) {
+			f->shown = level;
+			bam_setMask(1u << i, level);
+			dirty = true;
+		}
+	}
+	if (dirty)
+		bam_update();
+}
+
+uint8_t fade_level(uint8_t led) { // perceived brightness
+	return (led < BAM_LEDS) ? (fade_led[led].pos >> 8) : 0;
+}
+
+bool fade_busy(void) {
+	return fade_moving != 0;
+}
@@ -0,0 +1,20 @@
+#ifndef FADE_H
+#define FADE_H
+
+
+#define FADE_FULL        255        // perceived brightness, fully on
+
+void    fade_set     (uint16_t mask, uint8_t level);
+void    fade_setMask (uint16_t mask, uint16_t on);
+void    fade_to      (uint16_t mask, uint8_t level, uint16_t ms);
+void    fade_in      (uint16_t mask, uint16_t ms);
+void    fade_out     (uint16_t mask, uint16_t ms);
+void    fade_cross   (uint16_t from, uint16_t to, uint16_t ms);
+void    fade_breathe (uint16_t mask, uint16_t periodMs);
+
+void    fade_tick    (void);
+uint8_t fade_level   (uint8_t led);
+bool    fade_busy    (void);
+
+
+#endif
@@ -0,0 +1,103 @@
+/*
+ * filter.c – Fixed-point axis filtering for the EVi Classic firmware
+ *
+ * Purpose: Smooth the quantized slider axis between the pad scan and the joystick report with an
+ *          alpha-beta or one-euro filter, then hold the output inside a hysteresis band and snap a
+ *          deadzone to center, so a finger resting on a pad boundary stops flooding the host. A
+ *          finger at rest still ends on its exact position, full scale included.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include <stdlib.h>
+#include "conf_joystick.h"
+
+#include "filter.h"
+
+#define FILTER_MAX   0xFF00L   // 255.0
+
+static uint8_t flt_type     = CONFIG_JSTK_FILTER;
+static uint8_t flt_hyst     = CONFIG_JSTK_HYSTERESIS;
+static uint8_t flt_deadzone = CONFIG_JSTK_DEADZONE;
+
+
+void filter_init(filter_t *f) {
+	f->x    = FILTER_CENTER;
+	f->v    = 0;
+	f->out  = FILTER_CENTER;
+	f->meas = FILTER_CENTER;
+	f->live = false;
+}
+
+static int32_t flt_step(filter_t *f, int32_t meas) {
+	int32_t x, r, alpha;
+
+	switch (flt_type) {
+	case FILTER_ALPHA_BETA:                         // predict, then correct by a share of the residual
+		x     = f->x + f->v;
+		r     = meas - x;
+		x    += (r * CONFIG_JSTK_AB_ALPHA) >> 8;
+		f->v += ((r * CONFIG_JSTK_AB_BETA) >> 8);
+		return x;
+	case FILTER_ONE_EURO:                           // resting fingers get the low cutoff, strokes the high
+		r     = meas - f->x;
+		f->v += (((r - f->v) * CONFIG_JSTK_EURO_DCUTOFF) >> 8);
+		alpha = CONFIG_JSTK_EURO_MINCUTOFF + ((labs(f->v) * CONFIG_JSTK_EURO_BETA) >> 8);
+		if (alpha > 256)
+			alpha = 256;
+		return f->x + ((r * alpha) >> 8);
+	default:
+		return meas;
+	}
+}
+
+// axis 0-255 in, 8.8 out (0x0000-0xFF00), FILTER_CENTER without contact
+uint16_t filter_update(filter_t *f, uint8_t axis, bool contact) {
+	int32_t  meas = (int32_t)axis << 8;
+	int32_t  x;
+	uint16_t out;
+
+	if (!contact) {
+		filter_init(f);
+		return FILTER_CENTER;
+	}
+	if (!f->live) {                                 // touch-down starts at the finger, not at center
+		f->live = true;
+		f->x    = meas;
+		f->v    = 0;
+		f->out  = (uint16_t)meas;
+		f->meas = (uint16_t)meas;
+	}
+
+	x = flt_step(f, meas);
+	if (x < 0)          x = 0;
+	if (x > FILTER_MAX) x = FILTER_MAX;
+	f->x = x;
+
+	if (labs(x - f->out) > ((int32_t)flt_hyst << 8)) // hysteresis band around the last output
+		f->out = (uint16_t)x;
+	else if (meas == f->meas && labs(x - meas) < 0x100) // input at rest: end on it, not inside the band
+		f->out = (uint16_t)meas;
+	f->meas = (uint16_t)meas;
+
+	out = f->out;
+	if (labs((int32_t)out - FILTER_CENTER) <= ((int32_t)flt_deadzone << 8))
+		out = FILTER_CENTER;
+	return out;
+}
+
+void filter_setConfig(uint8_t type, uint8_t hyst, uint8_t deadzone) {
+	if (type > FILTER_ONE_EURO)
+		return;
+	flt_type     = type;
+	flt_hyst     = hyst;
+	flt_deadzone = (deadzone > 127) ? 127 : deadzone;
+}
+
+void filter_getConfig(uint8_t *cfg) { // type, hysteresis, deadzone
+	cfg[0] = flt_type;
+	cfg[1] = flt_hyst;
+	cfg[2] = flt_deadzone;
+}
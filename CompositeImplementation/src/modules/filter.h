@@ -0,0 +1,26 @@
+#ifndef FILTER_H
+#define FILTER_H
+
+
+#define FILTER_NONE         0   // raw quantized position
+#define FILTER_ALPHA_BETA   1   // fixed gain position/velocity tracker
+#define FILTER_ONE_EURO     2   // low-pass whose cutoff rises with speed
+
+#define FILTER_CENTER       0x8000  // 8.8 axis units, no contact
+
+typedef struct {
+	int32_t  x;      // filtered position, 8.8 axis units
+	int32_t  v;      // velocity (alpha-beta) or smoothed derivative (one-euro), 8.8 units per frame
+	uint16_t out;    // value last handed out, moves only outside the hysteresis band
+	uint16_t meas;   // measurement of the previous update, 8.8
+	bool     live;   // contact on the previous update
+} filter_t;
+
+void     filter_init      (filter_t *f);
+uint16_t filter_update    (filter_t *f, uint8_t axis, bool contact);
+
+void     filter_setConfig (uint8_t type, uint8_t hyst, uint8_t deadzone);
+void     filter_getConfig (uint8_t *cfg);
+
+
+#endif
@@ -0,0 +1,210 @@
+/*
+ * gesture.c – Slider gesture recognizer for the EVi Classic firmware
+ *
+ * Purpose: Recognize taps, double-taps, long-presses and swipes (with speed) on each slider from
+ *          the debounced pads, timed by the scanner tick so host scheduling never skews them,
+ *          and send the gestures as configurable keyboard usages.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include <stdlib.h>
+#include <string.h>
+#include "conf_input.h"
+#include "conf_gesture.h"
+
+#include "input.h"
+#include "gesture.h"
+#include "stats.h"
+
+#define GST_PADS         12                              // pads per slider
+#define GST_PAD_MASK   ((1u << GST_PADS) - 1)
+#define GST_RING_MASK   (CONFIG_GESTURE_RING_SIZE - 1)
+
+#if CONFIG_GESTURE_RING_SIZE & GST_RING_MASK
+#  error CONFIG_GESTURE_RING_SIZE must be a power of 2
+#endif
+
+#define GST_TICKS(ms)   ((uint16_t)((ms) * 1L * CONFIG_INPUT_SCAN_HZ / 1000))
+
+#define GST_IDLE  0     // no contact
+#define GST_DOWN  1     // touching, not decided yet
+#define GST_HELD  2     // long-press sent, waiting for lift
+
+typedef struct {
+	uint8_t  state;
+	int8_t   origin;      // half-pad position at touch-down
+	int8_t   pos;         // latest half-pad position
+	bool     second;      // touched within the double-tap gap of a pending tap
+	bool     tapPending;  // tap lifted, waiting to see if a second one follows
+	uint16_t downTick;
+	uint16_t tapTick;     // lift of the pending tap
+} gst_slider_t;
+
+static gst_slider_t     gst_slider[2];
+static uint16_t         gst_ticks;                             // scanner ticks (wraps)
+
+static gesture_t        gst_ring[CONFIG_GESTURE_RING_SIZE];
+static volatile uint8_t gst_head;                              // written by the scanner only
+static volatile uint8_t gst_tail;                              // written by the consumer only
+
+static uint8_t          gst_map[GESTURE_MAP_SIZE] = CONFIG_GESTURE_MAP;
+static gesture_t        gst_last;
+
+
+/* ---------------------------------------------------------------------- */
+/* ---------------------- recognizer (scanner tick) --------------------- */
+/* ---------------------------------------------------------------------- */
+static void gst_emit(uint8_t slider, uint8_t type, uint8_t speed) {
+	uint8_t head = gst_head;
+	uint8_t next = (head + 1) & GST_RING_MASK;
+
+	if (next == gst_tail) {                        // consumer behind, drop the gesture
+		stats.gesturesDropped++;
+		return;
+	}
+	gst_ring[head].slider = slider;
+	gst_ring[head].type   = type;
+	gst_ring[head].speed  = speed;
+	gst_head = next;                               // publish after the slot is written
+	stats.gestures++;
+}
+
+static void gst_flushTap(uint8_t s, gst_slider_t *g) { // a pending tap that got no second one
+	if (g->tapPending) {
+		g->tapPending = false;
+		gst_emit(s, GESTURE_TAP, 0);
+	}
+	g->second = false;
+}
+
+static void gst_lift(uint8_t s, gst_slider_t *g) {
+	uint16_t dt     = gst_ticks - g->downTick;
+	uint8_t  travel = abs(g->pos - g->origin);
+
+	if (travel >= CONFIG_GESTURE_SWIPE_MIN) {
+		gst_flushTap(s, g);
+		if (dt <= GST_TICKS(CONFIG_GESTURE_SWIPE_MS)) { // slower strokes are drags, no gesture
+			uint16_t speed = (uint16_t)travel * (CONFIG_INPUT_SCAN_HZ / 2) / (dt ? dt : 1);
+			gst_emit(s, (g->pos > g->origin) ? GESTURE_SWIPE_POS : GESTURE_SWIPE_NEG,
+			         (speed > 255) ? 255 : (uint8_t)speed);
+		}
+	} else if (dt <= GST_TICKS(CONFIG_GESTURE_TAP_MS)) {
+		if (g->second) {
+			g->tapPending = false;
+			g->second     = false;
+			gst_emit(s, GESTURE_DOUBLE_TAP, 0);
+		} else if (GST_TICKS(CONFIG_GESTURE_DOUBLE_MS) == 0) {
+			gst_emit(s, GESTURE_TAP, 0);
+		} else {
+			g->tapPending = true;
+			g->tapTick    = gst_ticks;
+		}
+	} else {
+		gst_flushTap(s, g);                        // too long for a tap, too short for a long-press
+	}
+}
+
+static void gst_update(uint8_t s, uint16_t m) {
+	gst_slider_t *g   = &gst_slider[s];
+	int8_t        pos = -1;
+
+	if (m)
+		pos = ctz(m) + (15 - clz(m));             // half-pads, midway between the outer pads touched
+
+	switch (g->state) {
+	case GST_IDLE:
+		if (pos < 0)
+			break;
+		g->state    = GST_DOWN;
+		g->origin   = pos;
+		g->pos      = pos;
+		g->downTick = gst_ticks;
+		g->second   = g->tapPending;              // still inside the gap, checked below
+		break;
+	case GST_DOWN:
+		if (pos < 0) {
+			gst_lift(s, g);
+			g->state = GST_IDLE;
+			break;
+		}
+		g->pos = pos;
+		if ((abs(pos - g->origin) < CONFIG_GESTURE_SWIPE_MIN) &&
+			((uint16_t)(gst_ticks - g->downTick) >= GST_TICKS(CONFIG_GESTURE_LONG_MS))) {
+			gst_flushTap(s, g);
+			gst_emit(s, GESTURE_LONG_PRESS, 0);
+			g->state = GST_HELD;
+		}
+		break;
+	default: // GST_HELD
+		if (pos < 0)
+			g->state = GST_IDLE;
+		break;
+	}
+
+	// the gap runs from the first lift to the second touch
+	if (g->tapPending && !g->second &&
+		((uint16_t)(gst_ticks - g->tapTick) > GST_TICKS(CONFIG_GESTURE_DOUBLE_MS)))
+		gst_flushTap(s, g);
+}
+
+// called by the scanner every tick with the debounced pads, vertical in 0-11, horizontal in 12-23
+void gesture_tick(uint32_t pads) {
+	gst_ticks++;
+	if (!pads && !gesture_busy())
+		return;
+	gst_update(GESTURE_VERT, (uint16_t)pads & GST_PAD_MASK);
+	gst_update(GESTURE_HORI, (uint16_t)(pads >> GST_PADS) & GST_PAD_MASK);
+}
+
+// true while a slider is mid-gesture, keeps the scanner from arming
+bool gesture_busy(void) {
+	return gst_slider[GESTURE_VERT].state || gst_slider[GESTURE_VERT].tapPending ||
+	       gst_slider[GESTURE_HORI].state || gst_slider[GESTURE_HORI].tapPending;
+}
+
+
+/* ---------------------------------------------------------------------- */
+/* --------------------------- report (USB frame) ----------------------- */
+/* ---------------------------------------------------------------------- */
+void gesture_report(void) {
+	if (input_getSnapshot()->testMode) {          // test mode: drop them, nothing goes to the host
+		gst_tail = gst_head;
+		return;
+	}
+
+	while (gst_tail != gst_head) {
+		uint8_t  tail = gst_tail;
+		uint8_t  code, n = 1;
+
+		gst_last = gst_ring[tail];
+		gst_tail = (tail + 1) & GST_RING_MASK;    // release the slot after it is read
+
+		code = gst_map[gst_last.slider * GESTURE_TYPES + gst_last.type];
+		if (!code)
+			continue;
+		if (gst_last.type >= GESTURE_SWIPE_NEG) { // faster swipes step further
+			n += gst_last.speed / CONFIG_GESTURE_SPEED_STEP;
+			if (n > CONFIG_GESTURE_REPEAT_MAX)
+				n = CONFIG_GESTURE_REPEAT_MAX;
+		}
+		while (n--) {
+			udi_hid_kbd_down(code);
+			udi_hid_kbd_up(code);
+		}
+	}
+}
+
+void gesture_setMap(uint8_t const *map) {
+	memcpy(gst_map, map, GESTURE_MAP_SIZE);
+}
+
+void gesture_getMap(uint8_t *map) {
+	memcpy(map, gst_map, GESTURE_MAP_SIZE);
+}
+
+void gesture_getLast(gesture_t *g) {
+	*g = gst_last;
+}
@@ -0,0 +1,32 @@
+#ifndef GESTURE_H
+#define GESTURE_H
+
+
+#define GESTURE_VERT        0   // slider, same order as the pad bits
+#define GESTURE_HORI        1
+
+#define GESTURE_TAP         0
+#define GESTURE_DOUBLE_TAP  1
+#define GESTURE_LONG_PRESS  2
+#define GESTURE_SWIPE_NEG   3   // down / left
+#define GESTURE_SWIPE_POS   4   // up / right
+#define GESTURE_TYPES       5
+
+#define GESTURE_MAP_SIZE   (2 * GESTURE_TYPES)
+
+typedef struct {
+	uint8_t slider;   // GESTURE_VERT or GESTURE_HORI
+	uint8_t type;     // GESTURE_TAP .. GESTURE_SWIPE_POS
+	uint8_t speed;    // swipes: pads per second (255 max), else 0
+} gesture_t;
+
+void gesture_tick     (uint32_t pads);
+bool gesture_busy     (void);
+
+void gesture_report   (void);
+void gesture_setMap   (uint8_t const *map);
+void gesture_getMap   (uint8_t *map);
+void gesture_getLast  (gesture_t *g);
+
+
+#endif
@@ -0,0 +1,258 @@
+/*
+ * input.c – Background input scanner for the EVi Classic firmware
+ *
+ * Purpose: Sample the keypad matrix and both sliders from a TCC0 overflow interrupt at
+ *          CONFIG_INPUT_SCAN_HZ, independent of USB enumeration, and hand every debounced
+ *          edge to the report code through a lock-free single-producer/single-consumer ring.
+ *          The slider gesture recognizer runs on the same tick. Once per frame the consumer
+ *          freezes the drained views into a snapshot that every report of that frame reads.
+ *          After CONFIG_INPUT_ARM_MS without contact the scanner stops, the keypad rows and
+ *          slider pads are armed for pin-change wake and the MCU may sleep past IDLE.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include "conf_input.h"
+
+#include "io.h"
+#include "input.h"
+#include "keypad.h"
+#include "joystick.h"
+#include "gesture.h"
+#include "sampler.h"
+#include "timebase.h"
+#include "debounce.h"
+#include "stats.h"
+
+#define INPUT_RING_MASK  (CONFIG_INPUT_RING_SIZE - 1)
+
+#if (CONFIG_INPUT_RING_SIZE & INPUT_RING_MASK) || (CONFIG_INPUT_RING_SIZE > 128)
+#  error CONFIG_INPUT_RING_SIZE must be a power of 2, 128 at most
+#endif
+
+#define INPUT_ARM_TICKS  ((uint16_t)(CONFIG_INPUT_ARM_MS * 1L * CONFIG_INPUT_SCAN_HZ / 1000))
+
+// a debounced edge is stamped back to the sample that first showed it (bounce-free contact)
+#define INPUT_EDGE_LAG_US  ((uint32_t)DEBOUNCE_LAG_TICKS * (1000000UL / CONFIG_INPUT_SCAN_HZ))
+
+static input_event_t    input_ring[CONFIG_INPUT_RING_SIZE];
+static volatile uint8_t input_head;          // next free slot, written by the scanner only
+static volatile uint8_t input_tail;          // next event to read, written by the consumer only
+static volatile bool    input_overflow;      // events were dropped, consumer must resync
+static volatile uint16_t input_ticks;        // scanner tick counter (wraps)
+
+static volatile bool    input_armed;         // scanner stopped, waiting for a pin change
+static uint16_t         input_idle;          // ticks without any contact
+static uint16_t         input_wakeTick;      // tick of the last wake
+static volatile bool    input_wakePending;   // wake seen, no report sent yet
+static volatile bool    input_test;          // test switch closed at the last tick
+
+static input_snapshot_t input_snap;          // consumer side, rebuilt once per frame
+
+
+void input_init(void) {
+	input_head     = 0;
+	input_tail     = 0;
+	input_overflow = false;
+	input_armed    = false;
+	input_idle     = 0;
+
+	timebase_init();                     // edge timestamps
+	sleepmgr_lock_mode(SLEEPMGR_IDLE);   // TCC0 needs clk_per, held while the scanner runs
+
+	sysclk_enable_module(SYSCLK_PORT_C, SYSCLK_TC0);
+	TCC0.CTRLB    = TC_WGMODE_NORMAL_gc;
+	TCC0.PER      = (sysclk_get_per_hz() / 64 / CONFIG_INPUT_SCAN_HZ) - 1;
+	TCC0.INTCTRLA = TC_OVFINTLVL_LO_gc; // same level as USB, so SOF and scans never preempt each other
+	TCC0.CTRLA    = TC_CLKSEL_DIV64_gc;
+
+#if CONFIG_INPUT_DMA
+	sampler_init();                     // slider ports oversampled by DMA, voted per tick
+#endif
+
+#if CONFIG_INPUT_PROFILE
+	sysclk_enable_module(SYSCLK_PORT_E, SYSCLK_TC0);
+	TCE0.CTRLB    = TC_WGMODE_NORMAL_gc;
+	TCE0.PER      = 0xFFFF;
+#endif
+}
+
+
+/* ---------------------------------------------------------------------- */
+/* ------------------------------ producer ------------------------------ */
+/* ---------------------------------------------------------------------- */
+static void input_push(uint8_t src, uint32_t changed, uint32_t state, uint32_t time) {
+	while (changed) {
+		uint8_t bit = ctz(changed);
+		changed &= changed - 1;              // clear lowest set bit
+
+		uint8_t head = input_head;
+		uint8_t next = (head + 1) & INPUT_RING_MASK;
+		if (next == input_tail) {            // ring full
+			input_overflow = true;
+			return;
+		}
+		input_ring[head].src     = src;
+		input_ring[head].bit     = bit;
+		input_ring[head].pressed = (state >> bit) & 1;
+		input_ring[head].time    = time;
+		input_head = next;                   // publish after the slot is written
+	}
+}
+
+/* ---------------------------------------------------------------------- */
+/* ------------------------------ wake/arm ------------------------------ */
+/* ---------------------------------------------------------------------- */
+static void input_arm(void) {
+	bool touched = keypad_arm() | jstk_arm(); // both must run
+
+	PORTB.INT0MASK |= PIN4_bm;               // test switch wakes as well
+	if (touched || !(IO_IN(B) & PIN4_bm)) {  // level already low, no edge will come
+		keypad_disarm();
+		jstk_disarm();
+		input_idle = 0;
+		return;
+	}
+
+	TCC0.CTRLA  = TC_CLKSEL_OFF_gc;
+#if CONFIG_INPUT_DMA
+	sampler_stop();
+#endif
+	input_armed = true;
+	sleepmgr_unlock_mode(SLEEPMGR_IDLE);
+}
+
+static void input_wake(void) {
+	if (!input_armed)
+		return;
+
+	keypad_disarm();
+	jstk_disarm();
+	input_armed = false;
+	input_idle  = 0;
+
+	sleepmgr_lock_mode(SLEEPMGR_IDLE);
+	TCC0.CNT   = 0;
+	TCC0.CTRLA = TC_CLKSEL_DIV64_gc;
+#if CONFIG_INPUT_DMA
+	sampler_start();
+#endif
+
+	stats.wakeCount++;
+	input_wakeTick    = input_ticks;
+	input_wakePending = true;
+}
+
+ISR(PORTF_INT0_vect) { input_wake(); }  // keypad rows
+ISR(PORTC_INT0_vect) { input_wake(); }  // vertical slider
+ISR(PORTD_INT0_vect) { input_wake(); }  // vertical slider
+ISR(PORTE_INT0_vect) { input_wake(); }  // horizontal slider
+ISR(PORTB_INT0_vect) { input_wake(); }  // horizontal slider, test switch
+
+ISR(TCC0_OVF_vect) {
+	uint32_t changed;
+	uint32_t keys, pads;
+	uint32_t edge = timebase_now() - INPUT_EDGE_LAG_US; // this tick's sample, back to its first
+
+#if CONFIG_INPUT_PROFILE
+	TCE0.CNT   = 0;
+	TCE0.CTRLA = TC_CLKSEL_DIV1_gc;      // clk_per = clk_cpu, counts CPU cycles
+#endif
+	changed = keypad_poll();
+	keys    = keypad_getMatrix();
+	if (changed)
+		input_push(INPUT_SRC_KEYPAD, changed, keys, edge);
+
+	changed = jstk_poll();
+	pads    = jstk_getState();
+#if CONFIG_INPUT_PROFILE
+	TCE0.CTRLA = TC_CLKSEL_OFF_gc;
+	stats.scanCycles = TCE0.CNT;
+	if (stats.scanCycles > stats.scanCyclesMax)
+		stats.scanCyclesMax = stats.scanCycles;
+#endif
+	if (changed)
+		input_push(INPUT_SRC_SLIDER, changed, pads, edge);
+	gesture_tick(pads);
+
+	input_ticks++;
+	input_test = !(IO_IN(B) & PIN4_bm);
+
+	if (keys || pads || gesture_busy() || input_test) // test mode keeps the scanner running
+		input_idle = 0;
+	else if (++input_idle >= INPUT_ARM_TICKS)
+		input_arm();
+}
+
+
+/* ---------------------------------------------------------------------- */
+/* ------------------------------ consumer ------------------------------ */
+/* ---------------------------------------------------------------------- */
+bool input_pop(input_event_t *ev) { // false when the ring is empty
+	uint8_t tail = input_tail;
+	if (tail == input_head)
+		return false;
+
+	*ev = input_ring[tail];
+	input_tail = (tail + 1) & INPUT_RING_MASK; // release the slot after it is read
+	return true;
+}
+
+bool input_lost(void) { // true once after events were dropped
+	if (!input_overflow)
+		return false;
+	input_overflow = false;
+	return true;
+}
+
+uint8_t input_getTicks(void) {
+	return (uint8_t)input_ticks;
+}
+
+bool input_isArmed(void) {
+	return input_armed;
+}
+
+// freezes the drained views after input_pop() ran dry, so the keypad, joystick, trackpad,
+// LED test mode and GUI reports of one frame agree and the slider scan runs once
+void input_snapshot(void) {
+	input_snap.tick     = input_getTicks();
+	input_snap.testMode = input_test;
+	input_snap.keys     = keypad_getView();
+	input_snap.pads     = jstk_getMap();
+	jstk_snapshot(&input_snap);
+}
+
+input_snapshot_t const *input_getSnapshot(void) {
+	return &input_snap;
+}
+
+// called once per USB frame, splits frames into armed and scanning for the stats page
+void input_frame(void) {
+	if (input_armed)
+		stats.armedFrames++;
+	else
+		stats.scanFrames++;
+}
+
+// called when a report carrying user input has been queued, closes a wake latency sample
+void input_reportSent(void) {
+	uint16_t latency;
+
+	stats_firstReport();
+
+	irqflags_t flags = cpu_irq_save();
+	if (!input_wakePending) {
+		cpu_irq_restore(flags);
+		return;
+	}
+	input_wakePending = false;
+	latency = input_ticks - input_wakeTick;
+
+	stats.wakeLatency = latency;
+	if (latency > stats.wakeLatencyMax)
+		stats.wakeLatencyMax = latency;
+	cpu_irq_restore(flags);
+}
@@ -0,0 +1,41 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+
+#define INPUT_SRC_KEYPAD   0    // bit = keypad matrix bit (col * KEYPAD_ROWS + row)
+#define INPUT_SRC_SLIDER   1    // bit = slider pad, vertical 0-11, horizontal 12-23
+
+typedef struct {
+	uint8_t  src;      // INPUT_SRC_KEYPAD or INPUT_SRC_SLIDER
+	uint8_t  bit;      // switch that changed
+	bool     pressed;  // new debounced state
+	uint32_t time;     // timebase_now() of the first sample showing the new level, us
+} input_event_t;
+
+// one frame's view of the inputs, every report built in that frame reads this copy
+typedef struct {
+	uint8_t  tick;        // scanner tick the views were drained up to
+	bool     testMode;    // test switch (PB4) closed
+	uint32_t keys;        // keypad matrix, bit (col * KEYPAD_ROWS + row)
+	uint32_t pads;        // slider pads, vertical 0-11, horizontal 12-23
+	int8_t   vertIdx;     // reported pad (oldest held), -1 without contact
+	int8_t   horiIdx;
+	int8_t   vertPos;     // half-pad centroid around the reported pad (0-22), -1 without contact
+	int8_t   horiPos;
+} input_snapshot_t;
+
+void    input_init     (void);
+
+bool    input_pop      (input_event_t *ev);
+bool    input_lost     (void);
+uint8_t input_getTicks (void);
+bool    input_isArmed  (void);
+
+void    input_snapshot (void);
+input_snapshot_t const *input_getSnapshot (void);
+
+void    input_frame       (void);
+void    input_reportSent  (void);
+
+
+#endif
@@ -4,7 +4,7 @@
  * Author: Rex Walters
  * Purpose: Configure and initialize all front‐panel I/O—set up LED drivers, keypad matrix scanning, 
  *          and joystick slider inputs by configuring port directions and pull-ups—and invoke the 
- *          led_init(), keypad_init(), and idleStart() routines to ready the hardware for operation.
+ *          led_init(), keypad_init(), input_init() and script_init() routines to ready the hardware for operation.
  *
  * History:
  *   Created March 5, 2024
@@ -19,6 +19,8 @@
 #include "io.h"
 #include "led.h"
 #include "keypad.h"
+#include "input.h"
+#include "script.h"
 
 //********************************************************************
 //  Section - Code - C Functions
@@ -151,9 +153,21 @@ static void initialize_PortF_io(void)
 }
 
 
+//===================================================================
+static void initialize_VPorts(void)
+{
+	// Maps the ports read on every input scan onto the virtual ports (see io.h)
+#if CONF_BOARD_IO_VPORT
+	PORTCFG.VPCTRLA = PORTCFG_VP02MAP_PORTF_gc | PORTCFG_VP13MAP_PORTB_gc;	  // VPORT0 = F, VPORT1 = B
+	PORTCFG.VPCTRLB = PORTCFG_VP02MAP_PORTC_gc | PORTCFG_VP13MAP_PORTD_gc;	  // VPORT2 = C, VPORT3 = D
+#endif
+}
+
+
 //===================================================================
 void io_init(void)
 {
+	initialize_VPorts();		// (keypad & slider scan ports)
 	initialize_PortA_io();		// (Alarm LED Signals)
 	initialize_PortB_io();		// (Horizontal Slider Switch signals), (Status LED Signal), (F2-F4_COL Keypad Scan Code Signal), (Spare IO)
 	initialize_PortC_io();		// (Vertical Slider Switch signals), (I2C signals)
@@ -163,5 +177,7 @@ void io_init(void)
 
 	led_init();
 	keypad_init();
-	idleStart();
+	input_init();
+	script_init();
+	script_runIdle();
 }
@@ -1,6 +1,32 @@
 #ifndef IO_H
 #define IO_H
 
+#include "conf_board.h"   // CONF_BOARD_IO_VPORT, asf.h only pulls it into the board init
+
+/*
+ * hot-path port access for the input scan. with CONF_BOARD_IO_VPORT the ports
+ * go through their virtual port (single-cycle I/O space), otherwise through the
+ * regular PORT registers. p is the port letter: IO_IN(F), IO_CLR(B, PIN7_bm).
+ */
+#if CONF_BOARD_IO_VPORT
+#  define IO_FAST_F        VPORT0
+#  define IO_FAST_B        VPORT1
+#  define IO_FAST_C        VPORT2
+#  define IO_FAST_D        VPORT3
+#  define IO_SET(p, m)     (IO_FAST_##p.OUT |=  (m))   // sbi for a single bit
+#  define IO_CLR(p, m)     (IO_FAST_##p.OUT &= ~(m))   // cbi for a single bit
+#else
+#  define IO_FAST_F        PORTF
+#  define IO_FAST_B        PORTB
+#  define IO_FAST_C        PORTC
+#  define IO_FAST_D        PORTD
+#  define IO_SET(p, m)     (IO_FAST_##p.OUTSET = (m))
+#  define IO_CLR(p, m)     (IO_FAST_##p.OUTCLR = (m))
+#endif
+#define IO_FAST_E          PORTE                       // no virtual port left
+#define IO_IN(p)           (IO_FAST_##p.IN)
+#define IO_OUT(p, v)       (IO_FAST_##p.OUT = (v))
+
 
 void io_init(void);
 
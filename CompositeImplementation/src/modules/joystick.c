@@ -3,24 +3,47 @@
  *
  * Author: Jackson Clary
  * Purpose: Read the two 12-position sliders as discrete button presses,
- *          convert positions to HID axis values and LED mask bits,
- *          and send USB HID joystick reports when the slider position changes.
+ *          convert positions (whole pads, or half-pad centroids) to HID axis values and LED mask bits,
+ *          filter the axes against boundary flicker, and send USB HID joystick reports when the
+ *          filtered position changes.
  *
  * History:
  *   Created May 29, 2025
  */
 
 #include <asf.h>
+#include <string.h>
+#include "conf_joystick.h"
+#include "conf_input.h"
 
+#include "io.h"
+#include "input.h"
 #include "joystick.h"
+#include "debounce.h"
+#include "filter.h"
+#include "sampler.h"
+#include "stats.h"
 
 #define AXIS_VERT       0
 #define AXIS_HORI       1
 #define SLIDER_COUNT   12
 #define SLIDER_MASK  ((1u << SLIDER_COUNT) - 1) // 0x0FFF
 
+#if CONFIG_JSTK_INTERPOLATE
+#  define JSTK_HORI()     (input_getSnapshot()->horiPos)    // half-pad position
+#  define JSTK_VERT()     (input_getSnapshot()->vertPos)
+#  define JSTK_AXIS(p)    jstk_posToAxis(p)
+#else
+#  define JSTK_HORI()     (input_getSnapshot()->horiIdx)    // whole pad
+#  define JSTK_VERT()     (input_getSnapshot()->vertIdx)
+#  define JSTK_AXIS(p)    jstk_idxToAxis(p)
+#endif
+
 uint8_t jstk_mask;  // bitmask of LED's to turn on
 
+static debounce_t jstk_debounce;    // debounced pads, vertical in 0-11, horizontal in 12-23 (scanner interrupt)
+static uint32_t   jstk_view;        // pads rebuilt from scanner events, same layout
+
 
 /*
 static int8_t jstk_scan(uint16_t jstk_bits)
@@ -43,84 +66,40 @@ static int8_t jstk_scan(uint16_t jstk_bits)
     return -1;
 }
 */
-static int8_t jstk_scan(uint8_t axis, uint16_t bits)
+/*
+ * trailing pad joystick: reports the oldest pad still pressed on an axis.
+ * every pad gets an order stamp on its press edge (same-call presses stamp in
+ * index order). the reported pad holds until released, then the held pad with
+ * the oldest stamp takes over. ages (clock - stamp) keep the compare wrap-safe.
+ */
+static int8_t jstk_scan(uint8_t axis, uint16_t pressed)
 {
-    // /* ------------- leading pad joystick -------------- */
-    // static int8_t head[2] = {-1, -1};
-    // static int8_t next[2][SLIDER_COUNT];
-    // static uint8_t inlist[2][SLIDER_COUNT] = {{0}};
-
-    // uint16_t pressed = (~bits) & SLIDER_MASK;
-
-    // // insert new pressed to the front of stack (FIFO)
-    // for (int8_t i = 0; i < SLIDER_COUNT; i++) {
-    //     if ((pressed & (1u << i)) && !inlist[axis][i]) {
-    //         next[axis][i] = head[axis]; // push to front
-    //         head[axis] = i;
-    //         inlist[axis][i] = 1;
-    //     }
-    // }
-
-    // // remove released pads from llist
-    // int8_t *p = &head[axis];
-    // while(*p != -1) {
-    //     int8_t idx = *p;
-    //     if (!(pressed & (1u << idx))) {  // pad released?
-    //         *p = next[axis][idx];        // unlink node
-    //         inlist[axis][idx] = 0;       // do not advance p, `next` is the new `curr`
-    //     } else {
-    //         p = &next[axis][idx];        // step forward
-    //     }
-    // } // O(N^2), i'm fine with it because list is small
-
-    // return head[axis];
-
-    
-    /* ------------- trailing pad joystick ------------- */
-    static int8_t head[2] = {-1, -1};   // oldest pressed pad
-    static int8_t tail[2] = {-1, -1};   // newest pressed pad
-    static int8_t next[2][SLIDER_COUNT];
-    static uint8_t inlist[2][SLIDER_COUNT] = {{0}};
-
-    uint16_t pressed = (~bits) & SLIDER_MASK;
-
-    // insert new presses to the back of queue (LIFO)
-    for (int8_t i = 0; i < SLIDER_COUNT; i++) {
-        if ((pressed & (1u << i)) && !inlist[axis][i]) {
-            next[axis][i] = -1; // push to tail
-            if (tail[axis] == -1) { // if list is empty
-                head[axis] = tail[axis] = i;
-            } else {
-                next[axis][tail[axis]] = i;
-                tail[axis] = i;
-            }
-            inlist[axis][i] = 1;
+    static uint16_t held[2];                    // pads pressed at the last call
+    static uint16_t clock[2];                   // order stamp counter
+    static uint16_t stamp[2][SLIDER_COUNT];     // stamp of each pad's last press
+    static int8_t   oldest[2] = {-1, -1};       // reported pad
+
+    uint16_t down = pressed & ~held[axis];      // new press edges
+    held[axis] = pressed;
+
+    for (uint16_t b = down; b; b &= b - 1)
+        stamp[axis][ctz(b)] = ++clock[axis];
+
+    if (oldest[axis] >= 0 && (pressed & (1u << oldest[axis])))
+        return oldest[axis];                    // still down, anything newer can't win
+
+    int8_t   best    = -1;
+    uint16_t bestAge = 0;
+    for (uint16_t b = pressed; b; b &= b - 1) { // at most SLIDER_COUNT, only on release
+        uint8_t  i   = ctz(b);
+        uint16_t age = clock[axis] - stamp[axis][i];
+        if (best < 0 || age > bestAge) {
+            best    = i;
+            bestAge = age;
         }
     }
-
-    // remove released pads from queue
-    int8_t prev = -1;
-    int8_t curr = head[axis];
-
-    while (curr != -1) {
-        if (!(pressed & (1u << curr))) {    // pad released?
-            if (prev == -1) // remove head case
-                head[axis] = next[axis][curr];
-            else
-                next[axis][prev] = next[axis][curr];
-
-            if (tail[axis] == curr) // remove tail case
-                tail[axis] = prev;
-
-            inlist[axis][curr] = 0;
-            curr = (prev == -1) ? head[axis] : next[axis][prev];
-        } else {
-            prev = curr;
-            curr = next[axis][curr];
-        }
-    }
-
-    return head[axis];
+    oldest[axis] = best;
+    return best;
 }
 
 /*
@@ -130,27 +109,108 @@ static int8_t jstk_scan(uint8_t axis, uint16_t bits)
 
 // vertical slider
 static uint16_t jstk_readVertRaw(void) {
-    uint8_t jstk_c = PORTC.IN;
-    uint8_t jstk_d = PORTD.IN;
+    uint8_t jstk_c = IO_IN(C);
+    uint8_t jstk_d = IO_IN(D);
     uint16_t jstk_w = ((uint16_t)jstk_d << 8) | jstk_c; // build 16 bit word
     jstk_w >>= 2;                                       // discard C0 & C1
     return jstk_w & 0x0FFF;                             // keep only bits 0–11
 }   // only return C2-C7 and D0-D5
 
 int8_t jstk_readVertIndex(void) {
-    return jstk_scan(AXIS_VERT, jstk_readVertRaw());
+    return jstk_scan(AXIS_VERT, (uint16_t)jstk_view & SLIDER_MASK);
 }
 
 // horizontal slider
 static uint16_t jstk_readHoriRaw(void) {
-    uint8_t jstk_e = PORTE.IN;
-    uint8_t jstk_b = PORTB.IN;
+    uint8_t jstk_e = IO_IN(E);
+    uint8_t jstk_b = IO_IN(B);
     uint16_t jstk_w = ((uint16_t)jstk_b << 8) | jstk_e;
     return jstk_w & 0x0FFF;	// B4–B7 = bits 12-15, so they get discarded
 }
 
 int8_t jstk_readHoriIndex(void) {
-    return jstk_scan(AXIS_HORI, jstk_readHoriRaw());
+    return jstk_scan(AXIS_HORI, (uint16_t)(jstk_view >> SLIDER_COUNT) & SLIDER_MASK);
+}
+
+#if CONFIG_INPUT_DMA
+// majority of the tick's DMA samples, same layout as the raw reads (which arming still uses)
+static uint16_t jstk_sampleVert(void) {
+    uint16_t jstk_w = ((uint16_t)sampler_vote(SAMPLER_PORT_D) << 8) | sampler_vote(SAMPLER_PORT_C);
+    return (jstk_w >> 2) & 0x0FFF;
+}
+static uint16_t jstk_sampleHori(void) {
+    uint16_t jstk_w = ((uint16_t)sampler_vote(SAMPLER_PORT_B) << 8) | sampler_vote(SAMPLER_PORT_E);
+    return jstk_w & 0x0FFF;
+}
+#else
+#  define jstk_sampleVert()  jstk_readVertRaw()
+#  define jstk_sampleHori()  jstk_readHoriRaw()
+#endif
+
+// samples both sliders once and runs them through the debouncer (scanner interrupt)
+uint32_t jstk_poll(void) { // returns the pads whose debounced state changed
+    // invert & mask (1 = pressed, 0 = released)
+    uint16_t mapV = (~jstk_sampleVert()) & SLIDER_MASK;
+    uint16_t mapH = (~jstk_sampleHori()) & SLIDER_MASK;
+
+    return debounce_update(&jstk_debounce, ((uint32_t)mapH << SLIDER_COUNT) | mapV);
+}
+
+// arms pin-change wake on every pad, returns true if a pad is already touched
+bool jstk_arm(void) {
+    PORTC.INTFLAGS = PORT_INT0IF_bm;    // vertical C2-C7
+    PORTC.INT0MASK = 0xFC;
+    PORTC.INTCTRL  = PORT_INT0LVL_LO_gc;
+    PORTD.INTFLAGS = PORT_INT0IF_bm;    // vertical D0-D5
+    PORTD.INT0MASK = 0x3F;
+    PORTD.INTCTRL  = PORT_INT0LVL_LO_gc;
+    PORTE.INTFLAGS = PORT_INT0IF_bm;    // horizontal E0-E7
+    PORTE.INT0MASK = 0xFF;
+    PORTE.INTCTRL  = PORT_INT0LVL_LO_gc;
+    PORTB.INTFLAGS = PORT_INT0IF_bm;    // horizontal B0-B3
+    PORTB.INT0MASK = 0x0F;
+    PORTB.INTCTRL  = PORT_INT0LVL_LO_gc;
+
+    return (jstk_readVertRaw() != SLIDER_MASK) || (jstk_readHoriRaw() != SLIDER_MASK);
+}
+
+void jstk_disarm(void) {
+    PORTC.INTCTRL = PORT_INT0LVL_OFF_gc;
+    PORTD.INTCTRL = PORT_INT0LVL_OFF_gc;
+    PORTE.INTCTRL = PORT_INT0LVL_OFF_gc;
+    PORTB.INTCTRL = PORT_INT0LVL_OFF_gc;
+    PORTC.INT0MASK = 0;
+    PORTD.INT0MASK = 0;
+    PORTE.INT0MASK = 0;
+    PORTB.INT0MASK = 0;
+}
+
+// debounced pads from the last scan, same layout as jstk_getMap()
+uint32_t jstk_getState(void) {
+    irqflags_t flags = cpu_irq_save();
+    uint32_t state = jstk_debounce.state;
+    cpu_irq_restore(flags);
+    return state;
+}
+
+// applies one pad edge from the scanner, in order, so the order stamps see the true press order
+void jstk_event(uint8_t bit, bool pressed) {
+    uint32_t mask = (uint32_t)1 << bit;
+
+    if (pressed)
+        jstk_view |= mask;
+    else
+        jstk_view &= ~mask;
+
+    if (bit < SLIDER_COUNT)
+        jstk_readVertIndex();
+    else
+        jstk_readHoriIndex();
+}
+
+// rebuilds the event view from the scanner after events were lost
+void jstk_sync(void) {
+    jstk_view = jstk_getState();
 }
 
 
@@ -168,6 +228,43 @@ uint8_t jstk_idxToAxis(int8_t idx) {
 }   // conversion runtime is O(1)
 
 
+static const uint8_t jstk_pos2axis[2 * SLIDER_COUNT - 1] = {
+    0,   12,  23,  35,  46,  58,  69,  81,
+    92,  104, 116, 128, 139, 151, 162, 174,
+    185, 197, 208, 220, 231, 243, 255
+};  // half-pad positions, even entries match jstk_idx2axis
+
+/*
+ * centroid of the run of touched pads around the reported pad, in half pads
+ * (lo + hi, 0-22). a finger straddling two pads lands between them.
+ */
+static int8_t jstk_centroid(int8_t idx, uint16_t pressed) {
+    if (idx < 0)
+        return -1;
+
+    uint32_t below = pressed & ((2u << idx) - 1);           // pads 0..idx
+    uint32_t gaps  = ~below & ((2u << idx) - 1);            // released pads 0..idx
+    uint8_t  lo    = gaps ? (32 - clz(gaps)) : 0;           // first pad above the last gap
+    uint8_t  hi    = idx + ctz(~((uint32_t)pressed >> idx)) - 1;
+
+    return lo + hi;
+}
+
+// reported pads and centroids for the frame snapshot, one jstk_scan() per axis
+void jstk_snapshot(input_snapshot_t *s) {
+    s->vertIdx = jstk_readVertIndex();
+    s->horiIdx = jstk_readHoriIndex();
+    s->vertPos = jstk_centroid(s->vertIdx, (uint16_t)s->pads & SLIDER_MASK);
+    s->horiPos = jstk_centroid(s->horiIdx, (uint16_t)(s->pads >> SLIDER_COUNT) & SLIDER_MASK);
+}
+
+uint8_t jstk_posToAxis(int8_t pos) {
+    if (pos < 0)
+        return 128; // return to center when no contact
+    return jstk_pos2axis[pos];
+}
+
+
 uint8_t jstk_ledMask(int8_t idx) // converts jstk button press index to LED mask
 {
     if (idx < 0)    // no touch detected
@@ -202,8 +299,8 @@ uint8_t jstk_ledMask(int8_t idx) // converts jstk button press index to LED mask
 
 uint8_t jstk_readMask(void) // test mode LED map
 {
-    int8_t vi = jstk_readVertIndex();       // -1 to 11
-    int8_t hi = jstk_readHoriIndex();       // -1 to 11
+    int8_t vi = input_getSnapshot()->vertIdx; // -1 to 11
+    int8_t hi = input_getSnapshot()->horiIdx; // -1 to 11
 
     if (vi < 0 && hi < 0)
         return 0;                           // no contact
@@ -219,14 +316,119 @@ uint8_t jstk_readMask(void) // test mode LED map
 
 
 
+/*
+ * report pacing: each axis runs through the filter stage (filter.c) before it is compared with
+ * the last report. jstk_replay() substitutes a finger flickering across a pad boundary for the
+ * pads, so the reports per second in the stats page can be compared between filter settings.
+ */
+#define JSTK_RATE_FRAMES  1000                  // stats.jstkRate window, 1 s of USB frames
+
+static filter_t jstk_filter[2];                 // AXIS_VERT, AXIS_HORI
+static uint32_t jstk_replayFrames;              // frames of synthetic jitter left, up to 255 s
+static uint8_t  jstk_lfsr = 0xA5;
+static uint16_t jstk_rateFrames;
+static uint16_t jstk_rateReports;
+
+void jstk_replay(uint8_t seconds) {
+    jstk_replayFrames = seconds * (uint32_t)JSTK_RATE_FRAMES;
+}
+uint8_t jstk_replayLeft(void) { // whole seconds, rounded up
+    return (jstk_replayFrames + JSTK_RATE_FRAMES - 1) / JSTK_RATE_FRAMES;
+}
+
+static int8_t jstk_replayPos(int8_t pad) { // random walk between a pad and its upper neighbour
+    jstk_lfsr = (jstk_lfsr >> 1) ^ (-(jstk_lfsr & 1) & 0xB8);
+#if CONFIG_JSTK_INTERPOLATE
+    return 2 * pad + (jstk_lfsr & 1) + ((jstk_lfsr >> 1) & 1);  // pad, both, neighbour
+#else
+    return pad + (jstk_lfsr & 1);
+#endif
+}
+
+static void jstk_sample(int8_t *x, int8_t *y) {
+    if (jstk_replayFrames) {
+        jstk_replayFrames--;
+        *x = jstk_replayPos(5);
+        *y = jstk_replayPos(7);
+    } else {
+        *x = JSTK_HORI();
+        *y = JSTK_VERT();
+    }
+}
+
+static uint16_t jstk_axis(uint8_t axis, int8_t pos) { // filtered axis, 8.8
+    return filter_update(&jstk_filter[axis], JSTK_AXIS(pos), pos >= 0);
+}
+
+static void jstk_rate(bool sent) { // reports per second, over fixed one second windows
+    if (sent) {
+        stats.jstkReports++;
+        jstk_rateReports++;
+    }
+    if (++jstk_rateFrames >= JSTK_RATE_FRAMES) {
+        stats.jstkRate   = jstk_rateReports;
+        jstk_rateFrames  = 0;
+        jstk_rateReports = 0;
+    }
+}
+
+
+#if UDI_HID_JSTK_HIRES
+/*
+ * 7 byte report: x, y (16 bit, little endian), contact flags (bit 0 x, bit 1 y),
+ * USB frame number the sample was taken in (16 bit, 11 used) for host side timing
+ */
+#define JSTK_CONTACT_X  (1u << 0)
+#define JSTK_CONTACT_Y  (1u << 1)
+
+static uint8_t jstk_usbReport[UDI_HID_JSTK_REPORT_IN_SIZE];
+static uint8_t jstk_prevReport[5] = {0x80, 0x80, 0x80, 0x80, 0};  // centered, no contact
+
+void jstk_usbTask(void) // build and send 7 byte report
+{
+    int8_t   x, y;
+    uint16_t ax, ay;
+    bool     sent = false;
+
+    jstk_sample(&x, &y);
+    ax  = jstk_axis(AXIS_HORI, x);
+    ay  = jstk_axis(AXIS_VERT, y);
+    ax += ax >> 8;                                              // 0-255.0 -> 0-65535
+    ay += ay >> 8;
+
+    jstk_usbReport[0] = (uint8_t)ax;
+    jstk_usbReport[1] = (uint8_t)(ax >> 8);
+    jstk_usbReport[2] = (uint8_t)ay;
+    jstk_usbReport[3] = (uint8_t)(ay >> 8);
+    jstk_usbReport[4] = ((x >= 0) ? JSTK_CONTACT_X : 0) | ((y >= 0) ? JSTK_CONTACT_Y : 0);
+
+    // send if value changed & IN endpoint ready, the frame number alone doesn't count
+    if (memcmp(jstk_usbReport, jstk_prevReport, sizeof(jstk_prevReport))) {
+        uint16_t frame = udd_get_frame_number();
+        jstk_usbReport[5] = (uint8_t)frame;
+        jstk_usbReport[6] = (uint8_t)(frame >> 8);
+
+        if (udi_hid_joystick_send_report_in(jstk_usbReport)) {   // IN endpoint ready?
+            memcpy(jstk_prevReport, jstk_usbReport, sizeof(jstk_prevReport));
+            input_reportSent();
+            sent = true;
+        }
+    }
+    jstk_rate(sent);
+}
+#else
 static uint8_t jstk_usbReport[2];
 static uint8_t jstk_prevReport[2] = {128, 128};
 
 void jstk_usbTask(void) // build and send 2 byte report
 {
-    // sample current joystick/slider indices
-    jstk_usbReport[0] = jstk_idxToAxis(jstk_readHoriIndex());    // x
-    jstk_usbReport[1] = jstk_idxToAxis(jstk_readVertIndex());    // y
+    int8_t x, y;
+    bool   sent = false;
+
+    // sample current joystick/slider positions, rounded back to 0-255
+    jstk_sample(&x, &y);
+    jstk_usbReport[0] = (jstk_axis(AXIS_HORI, x) + 0x80) >> 8;  // x
+    jstk_usbReport[1] = (jstk_axis(AXIS_VERT, y) + 0x80) >> 8;  // y
 
     // send if value changed & IN endpoint ready
     if ((jstk_usbReport[0] != jstk_prevReport[0]) ||
@@ -234,19 +436,15 @@ void jstk_usbTask(void) // build and send 2 byte report
         if (udi_hid_joystick_send_report_in(jstk_usbReport)) {   // IN endpoint ready?
             jstk_prevReport[0] = jstk_usbReport[0];
             jstk_prevReport[1] = jstk_usbReport[1];
+            input_reportSent();
+            sent = true;
         }
     }
+    jstk_rate(sent);
 }
+#endif
 
 uint32_t jstk_getMap(void) { // bitmap of both sliders button states
-    // raw 12 bit words (0 = pressed, 1 = released)
-    uint16_t rawV = jstk_readVertRaw();
-    uint16_t rawH = jstk_readHoriRaw();
-
-    // invert & mask (1 = pressed, 0 = released)
-    uint16_t mapV = (~rawV) & SLIDER_MASK;
-    uint16_t mapH = (~rawH) & SLIDER_MASK;
-
-    // pack vertical into 0-11 bits, horizontal in 12-23 bits
-    return ((uint32_t)mapH << SLIDER_COUNT) | mapV; // 24-31 bits unused
+    // debounced, vertical in 0-11 bits, horizontal in 12-23 bits (24-31 bits unused)
+    return jstk_view;
 }
\ No newline at end of file
@@ -1,15 +1,27 @@
 #ifndef JOYSTICK_H
 #define JOYSTICK_H
 
+#include "input.h"
 
 int8_t jstk_readVertIndex (void);
 int8_t jstk_readHoriIndex (void);
 uint8_t jstk_idxToAxis    (int8_t idx);
 
+void jstk_snapshot        (input_snapshot_t *s);
+uint8_t jstk_posToAxis    (int8_t pos);
+
 uint8_t jstk_readMask     (void);
 uint8_t jstk_ledMask      (int8_t idx);
 
+uint32_t jstk_poll        (void);
+uint32_t jstk_getState    (void);
+void jstk_event           (uint8_t bit, bool pressed);
+void jstk_sync            (void);
+bool jstk_arm             (void);
+void jstk_disarm          (void);
 void jstk_usbTask         (void);
+void jstk_replay          (uint8_t seconds);
+uint8_t jstk_replayLeft   (void);
 
 uint32_t jstk_getMap      (void);
 
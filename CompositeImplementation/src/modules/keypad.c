@@ -3,29 +3,48 @@
  *
  * Author: Jackson Clary
  * Purpose: Scan the 5×4 keypad matrix, decode discrete key presses, manage test-mode LED toggling,
- *          and send USB HID keyboard reports in normal mode or toggle LEDs in hardware test mode.
+ *          and send USB HID keyboard reports in normal mode (single key or N-key-rollover with
+ *          ghost detection) or toggle LEDs in hardware test mode.
  *
  * History:
  *   Created May 22, 2025
  */
 
 #include <asf.h>
+#include <string.h>
+#include "conf_keypad.h"
 
 #include "ui.h"
+#include "io.h"
 #include "led.h"
+#include "input.h"
 #include "keypad.h"
-
-
-// mapping of keypad layout: [column][row] → HID key code
-static volatile uint8_t kpd_keyAssign[KEYPAD_COLS][KEYPAD_ROWS];
-
-// output patterns to select each column when scanning
-static volatile uint8_t kpd_colAddr[KEYPAD_COLS];
-
-// raw scan values and detected indices
-static volatile uint8_t kpd_rowVal;             // raw row input bits (PF4-PF7)
-static volatile uint8_t kpd_detectedRow;        // detected row index
-static volatile uint8_t kpd_detectedCol;        // detected column index
+#include "stats.h"
+#include "debounce.h"
+
+
+// keymap record kept in EEPROM, overrides the flash defaults while valid
+#define KEYMAP_MAGIC  0x4B  // 'K'
+
+typedef struct {
+	uint8_t magic;
+	uint8_t map[KEYPAD_KEYS];
+	uint8_t check;         // complement of the byte sum of map[]
+} keymap_record_t;
+
+// mapping of keypad layout: matrix bit (col * KEYPAD_ROWS + row) → HID key code
+static uint8_t       kpd_keymap[KEYPAD_KEYS];   // RAM copy used at runtime
+static bool          kpd_keymapCustom;          // kpd_keymap came from EEPROM
+static volatile bool kpd_keymapDirty;           // RAM copy changed, EEPROM write pending
+
+// output patterns to select each column when scanning (active-low, col 4 is PB7)
+static const uint8_t kpd_colAddr[KEYPAD_COLS] = {
+	0x0E,   // 1110b – select col 0
+	0x0D,   // 1101b - select col 1
+	0x0B,   // 1011b - select col 2
+	0x07,   // 0111b - select col 3
+	0xFF,   // 1111b - select col 4
+};
 
 // current and previous press state and last key code
 static volatile uint8_t kpd_keyPressed;         // KEYPAD_PRESSED or KEYPAD_RELEASED
@@ -37,20 +56,73 @@ static volatile bool    kpd_multiPress = false; // multipress detection
 
 // test mode flags		
 static volatile uint8_t kpd_exitTestMode;       // flag to clear LEDs after test
-static volatile uint8_t kpd_testMode;           // hardware (switch) test mode input
-
-// key map variables
-static bool keyMap[16] = {0};                   // map of current keypad state
-static const int8_t keyIndex[KEYPAD_COLS][KEYPAD_ROWS] = {
-	{  8,  7, -1, -1 },
-	{  6,  5, -1, -1 },
-	{  4, -1, -1, -1 },
-	{ -1, -1,  0,  2 },
-	{ -1, -1,  1,  3 },
+static bool             kpd_testMode;           // hardware (switch) test mode input
+
+// packed key matrix: bit (col * KEYPAD_ROWS + row) is set while that key is down
+static volatile uint32_t kpd_matrix;            // debounced scan (scanner interrupt)
+static uint32_t          kpd_view;              // matrix rebuilt from scanner events
+static uint8_t           kpd_codeBit;           // matrix bit that produced kpd_code
+static debounce_t        kpd_debounce;          // contact bounce filter for the matrix
+
+// host reporting
+static uint8_t kpd_reportMode  = CONFIG_KEYPAD_REPORT_MODE;
+static uint8_t kpd_multiPolicy = CONFIG_KEYPAD_MULTIPRESS;
+static uint8_t kpd_sentCode;                    // code held down at the host (edge mode), 0 = none
+static uint32_t kpd_fresh;                      // held keys whose press edge may still be sent (edge mode)
+static uint32_t kpd_sentView;                   // keys held down at the host (NKRO mode)
+
+// LED toggled by each matrix position in hardware test mode
+static const uint8_t kpd_testLed[KEYPAD_KEYS] = {
+	LED1_PIN, LED8_PIN, 0,        0,         // col 0: NULL, CLEAR
+	LED7_PIN, LED6_PIN, 0,        0,         // col 1: ENTER, CANCEL
+	LED5_PIN, 0,        0,        0,         // col 2: Display
+	0,        0,        LED1_PIN, LED3_PIN,  // col 3: F1, F3
+	0,        0,        LED2_PIN, LED4_PIN,  // col 4: F2, F4
+};
+
+// factory keymap, used when EEPROM holds no valid override
+static PROGMEM_DECLARE(uint8_t, kpd_defaultMap[KEYPAD_KEYS]) = {
+	HID_N,     HID_BACKSPACE, 0,      0,       // col 0: NULL, CLEAR
+	HID_ENTER, HID_ESCAPE,    0,      0,       // col 1: ENTER, CANCEL
+	HID_D,     0,             0,      0,       // col 2: Display
+	0,         0,             HID_F1, HID_F3,  // col 3: F1, F3
+	0,         0,             HID_F2, HID_F4,  // col 4: F2, F4
 };
 
+static uint8_t keypad_keymapCheck(uint8_t const *map) {
+	uint8_t sum = 0;
+	for (uint8_t i = 0; i < KEYPAD_KEYS; ++i)
+		sum += map[i];
+	return ~sum;
+}
+
+// every code has to fit the keyboard report, a higher usage would never reach the host
+static bool keypad_keymapValid(uint8_t const *map) {
+	for (uint8_t i = 0; i < KEYPAD_KEYS; ++i)
+		if (map[i] > UDI_HID_KBD_NKRO_USAGE_MAX)
+			return false;
+	return true;
+}
+
+// loads the EEPROM keymap into RAM, or the flash defaults if it isn't valid
+static void keypad_loadKeymap(void)
+{
+	keymap_record_t rec;
+
+	nvm_eeprom_read_buffer(CONFIG_KEYPAD_KEYMAP_EEPROM, &rec, sizeof(rec));
+	if (rec.magic == KEYMAP_MAGIC && rec.check == keypad_keymapCheck(rec.map) &&
+		keypad_keymapValid(rec.map)) {
+		memcpy(kpd_keymap, rec.map, KEYPAD_KEYS);
+		kpd_keymapCustom = true;
+	} else {
+		for (uint8_t i = 0; i < KEYPAD_KEYS; ++i)
+			kpd_keymap[i] = PROGMEM_READ_BYTE(&kpd_defaultMap[i]);
+		kpd_keymapCustom = false;
+	}
+}
+
 /*
- * sets initial states and creates kpd_keyAssign matrix with HID codes.
+ * sets initial states and loads the keymap (EEPROM override or flash defaults).
  */
 void keypad_init(void)
 {
@@ -80,42 +152,11 @@ void keypad_init(void)
 	kpd_currState = KEYPAD_RELEASED;
 	kpd_prevState = KEYPAD_RELEASED;
 	kpd_exitTestMode = 0;
-	kpd_rowVal = 0;
 	kpd_code = 0;
+	debounce_init(&kpd_debounce);
 
 
-	// kpd_keyAssign[KEYPAD_COLS][KEYPAD_ROWS]
-	kpd_keyAssign[0][0] = HID_N;         // NULL Button
-	kpd_keyAssign[0][1] = HID_BACKSPACE; // CLEAR Button
-	kpd_keyAssign[0][2] = 0;
-	kpd_keyAssign[0][3] = 0;
-
-	kpd_keyAssign[1][0] = HID_ENTER;     // ENTER Button
-	kpd_keyAssign[1][1] = HID_ESCAPE;    // CANCEL Button
-	kpd_keyAssign[1][2] = 0;
-	kpd_keyAssign[1][3] = 0;
-
-	kpd_keyAssign[2][0] = HID_D;         // Display
-	kpd_keyAssign[2][1] = 0;
-	kpd_keyAssign[2][2] = 0;
-	kpd_keyAssign[2][3] = 0;
-
-	kpd_keyAssign[3][0] = 0;
-	kpd_keyAssign[3][1] = 0;
-	kpd_keyAssign[3][2] = HID_F1;        // F1 Button
-	kpd_keyAssign[3][3] = HID_F3;        // F3 Button
-
-	kpd_keyAssign[4][0] = 0;
-	kpd_keyAssign[4][1] = 0;
-	kpd_keyAssign[4][2] = HID_F2;        // F2 Button
-	kpd_keyAssign[4][3] = HID_F4;        // F4 Button
-
-	// Column‐select output patterns (active‐low)
-	kpd_colAddr[0] = 0x0E;	// 1110b – select col 0
-	kpd_colAddr[1] = 0x0D;	// 1101b - select col 1
-	kpd_colAddr[2] = 0x0B;	// 1011b - select col 2
-	kpd_colAddr[3] = 0x07;	// 0111b - select col 3
-	kpd_colAddr[4] = 0xFF;	// 1111b - select col 4
+	keypad_loadKeymap();
 }
 
 
@@ -127,175 +168,381 @@ uint8_t keypad_getState(void) {
 uint8_t keypad_getCode(void) {
 	return(kpd_code);
 }
+// get key matrix rebuilt from the drained scanner events, same layout as keypad_getMatrix()
+uint32_t keypad_getView(void) {
+	return kpd_view;
+}
+// get debounced key matrix from the last scan, bit (col * KEYPAD_ROWS + row)
+uint32_t keypad_getMatrix(void) {
+	irqflags_t flags = cpu_irq_save();
+	uint32_t matrix = kpd_matrix;
+	cpu_irq_restore(flags);
+	return(matrix);
+}
 
 
 /*
- * scans the keypad matrix
+ * scans the keypad matrix, building one packed word (one nibble per column).
+ * runs in the scanner interrupt, returns the keys whose debounced state changed.
+ * all columns are checked with a single read first, the per-column decode only
+ * runs while some key is down.
  */
-void keypad_poll(void)
+uint32_t keypad_poll(void)
 {
-	for (int i = 0; i < 9; i++) {
-		keyMap[i] = 0;
+	uint32_t matrix = 0;
+
+	// fast path: every column low at once, any key pulls its row low
+	IO_OUT(F, 0x00);
+	IO_CLR(B, PIN7_bm);
+	uint8_t anyRow = (~IO_IN(F)) & 0xF0;
+	IO_OUT(F, 0x0F);
+	IO_SET(B, PIN7_bm);
+
+	if (!anyRow) {
+		stats.scansSkipped++;
+		uint32_t changed = debounce_update(&kpd_debounce, 0);
+		kpd_matrix = kpd_debounce.state;
+		return changed;
 	}
-
-	// remember the previous raw row mask between scans
-	static uint8_t prevRowMask = 0;
-	// track the last detected key position
-	uint8_t lastRow = KEYPAD_ROWS, lastCol = KEYPAD_COLS;
-	// total keys seen this scan
-	uint8_t pressedCount = 0;
+	stats.scansFull++;
 
 	// scan each column
 	for (uint8_t col = 0; col < KEYPAD_COLS; ++col) {
-		PORTF.OUT = kpd_colAddr[col]; // drive column select (active = low)
+		IO_OUT(F, kpd_colAddr[col]); // drive column select (active = low)
 		// column 4 is wired to PB7 (not PF0-PF3), so drive PB7 low only when scanning that column
 		if (col == 4) {
-			PORTB.OUTCLR = PIN7_bm;
+			IO_CLR(B, PIN7_bm);
 		} else {
-			PORTB.OUTSET = PIN7_bm;
+			IO_SET(B, PIN7_bm);
 		}
 
-		uint8_t rowBits = PORTF.IN & 0xF0;   // read raw row bits (PortF4-7)
-		uint8_t rowMask = (~rowBits) & 0xF0; // invert & mask to get 1s wherever pressed
-
-		// add up the bits in column
-		if (rowMask & 0x10) pressedCount++;
-		if (rowMask & 0x20) pressedCount++;
-		if (rowMask & 0x40) pressedCount++;
-		if (rowMask & 0x80) pressedCount++;
-
-		for (uint8_t bit = 0; bit < KEYPAD_ROWS; bit++) {
-			if (rowMask & (1 << (bit + 4))) {
-				int8_t idx = keyIndex[col][bit];
-				if (idx >= 0 && idx < 9) {
-					keyMap[idx] = 1;
-				}
-			}
-		}
+		uint8_t rowMask = (~IO_IN(F)) & 0xF0; // invert & mask to get 1s wherever pressed (PF4-PF7)
+		matrix |= (uint32_t)(rowMask >> 4) << (col * KEYPAD_ROWS);
+	}
+	IO_SET(B, PIN7_bm); // deselect all columns
 
-		uint8_t selectMask; // if >1 bit is set, isolate the newest bit
-		if ((rowMask & (rowMask - 1)) != 0) {
-			uint8_t newMask = rowMask & ~prevRowMask; // 2 or more rows r low
-			if (!newMask) {
-				newMask = rowMask; // shouldn't happen but for redundancy
-			}
-			selectMask = newMask & (uint8_t)(-newMask); // pick LSB that's set (newest)
-		} else {
-			selectMask = rowMask; // single key press (or none)
+	uint32_t changed = debounce_update(&kpd_debounce, matrix);
+	kpd_matrix = kpd_debounce.state;
+	return changed;
+}
+
+/*
+ * arms pin-change wake: all columns driven low so any key pulls its row low.
+ * returns true if a key is already down (it would never produce an edge).
+ */
+bool keypad_arm(void)
+{
+	PORTF.OUTCLR   = 0x0F;                // columns PF0-PF3 low
+	PORTB.OUTCLR   = PIN7_bm;             // column 4 low
+	PORTF.INTFLAGS = PORT_INT0IF_bm;      // drop row edges left over from scanning
+	PORTF.INT0MASK = 0xF0;                // rows PF4-PF7
+	PORTF.INTCTRL  = PORT_INT0LVL_LO_gc;
+
+	return (PORTF.IN & 0xF0) != 0xF0;
+}
+
+void keypad_disarm(void)
+{
+	PORTF.INTCTRL  = PORT_INT0LVL_OFF_gc;
+	PORTF.INT0MASK = 0;
+	PORTF.OUTSET   = 0x0F;                // columns back to idle (high)
+	PORTB.OUTSET   = PIN7_bm;
+}
+
+// picks the code reported for the held keys (newest press wins)
+static void keypad_select(uint8_t bit) {
+	kpd_codeBit = bit;
+	kpd_code = kpd_keymap[bit];
+}
+
+/*
+ * applies one key edge from the scanner to the press state & code
+ */
+void keypad_event(uint8_t bit, bool pressed)
+{
+	uint32_t mask = (uint32_t)1 << bit;
+
+	if (pressed) {
+		kpd_view  |= mask;
+		kpd_fresh |= mask;
+		keypad_select(bit);                    // first key-down edge or new key w/o releasing old
+	} else {
+		kpd_view  &= ~mask;
+		kpd_fresh &= ~mask;
+		if (bit == kpd_codeBit && kpd_view)    // reported key released, fall back to a held one
+			keypad_select(31 - clz(kpd_view));
+	}
+	kpd_keyPressed = kpd_view ? KEYPAD_PRESSED : KEYPAD_RELEASED;
+	kpd_multiPress = ((kpd_view & (kpd_view - 1)) != 0); // more than one bit set
+}
+
+// rebuilds the event view from the scanner after events were lost
+void keypad_sync(void)
+{
+	uint32_t prev = kpd_view;
+
+	kpd_view  = keypad_getMatrix();
+	kpd_fresh = (kpd_fresh | (kpd_view & ~prev)) & kpd_view;   // keys that went down unseen count as new
+	if (kpd_view)
+		keypad_select(31 - clz(kpd_view));
+	kpd_keyPressed = kpd_view ? KEYPAD_PRESSED : KEYPAD_RELEASED;
+	kpd_multiPress = ((kpd_view & (kpd_view - 1)) != 0);
+}
+
+// releases the code(s) held down at the host, if any
+static void keypad_releaseSent(void)
+{
+	if (kpd_sentCode) {
+		udi_hid_kbd_up(kpd_sentCode);
+		kpd_sentCode = 0;
+	}
+	if (kpd_sentView) {
+		udi_hid_kbd_set(NULL, 0);
+		kpd_sentView = 0;
+	}
+}
+
+/*
+ * without diodes, three keys on the corners of a rectangle close the fourth
+ * corner too. any two columns sharing two or more rows are ambiguous.
+ */
+static bool keypad_isGhosted(uint32_t matrix)
+{
+	for (uint8_t a = 0; a < KEYPAD_COLS - 1; ++a) {
+		uint8_t rowsA = (matrix >> (a * KEYPAD_ROWS)) & 0x0F;
+		if ((rowsA & (rowsA - 1)) == 0)      // fewer than two rows, no rectangle
+			continue;
+		for (uint8_t b = a + 1; b < KEYPAD_COLS; ++b) {
+			uint8_t common = rowsA & (matrix >> (b * KEYPAD_ROWS));
+			if (common & (common - 1))
+				return true;
 		}
-		prevRowMask = rowMask; // save for next pass
-
-		// decode to row index
-		bool pressed = (selectMask != 0);
-		uint8_t rowIndex = 0;
-		switch (selectMask) {
-			case 0x10: rowIndex = 0;     break;
-			case 0x20: rowIndex = 1;     break;
-			case 0x40: rowIndex = 2;     break;
-			case 0x80: rowIndex = 3;     break;
-			default:   pressed  = false; break;
+	}
+	return false;
+}
+
+// NKRO mode: every held key in one report, a chord arrives in a single frame
+static void keypad_reportNkro(void)
+{
+	static bool kpd_ghost = false;
+	uint8_t codes[KEYPAD_KEYS];
+	uint8_t n = 0;
+
+	if (kpd_view == kpd_sentView)
+		return;
+	if (keypad_isGhosted(kpd_view)) {    // hold the last unambiguous set
+		if (!kpd_ghost)
+			stats.ghostBlocked++;
+		kpd_ghost = true;
+		return;
+	}
+	kpd_ghost = false;
+
+	for (uint32_t v = kpd_view; v; v &= v - 1) {
+		uint8_t bit = ctz(v);
+		codes[n++] = kpd_keymap[bit];
+	}
+	udi_hid_kbd_set(codes, n);
+	if (kpd_view & ~kpd_sentView)        // a new key went down
+		input_reportSent();
+	kpd_sentView = kpd_view;
+}
+
+// edge mode: key-down on the press edge, key-up on release
+static void keypad_reportEdge(void)
+{
+	static bool kpd_block = false;
+
+	if (kpd_keyPressed == KEYPAD_RELEASED) {
+		keypad_releaseSent();
+		kpd_block = false;
+		return;
+	}
+	if (kpd_block)
+		return;
+
+	if (kpd_multiPress) {
+		if (kpd_multiPolicy == KEYPAD_MULTI_BLOCK) {
+			keypad_releaseSent();     // chord, take back the key already sent
+			kpd_block = true;
+			return;
 		}
-		if (pressed) {
-			lastRow = rowIndex;
-			lastCol = col;
+		if (kpd_multiPolicy == KEYPAD_MULTI_FIRST) {
+			kpd_fresh = 0;            // keys joining a chord are never sent
+			return;
 		}
 	}
-	PORTB.OUTSET = PIN7_bm; // deselect all columns
-
-	if (lastRow < KEYPAD_ROWS) { // update global press state & code
-		uint8_t newCode = kpd_keyAssign[lastCol][lastRow];
-		// only update kpd_code on an *event* (initial press or key-change)
-		if (kpd_keyPressed == KEYPAD_RELEASED) {	// skip if same key is still held
-			kpd_code = newCode;						// first key-down edge
-			kpd_keyPressed = KEYPAD_PRESSED;
-		} else if (newCode != kpd_code) {			// new keypress w/o releasing old
-			kpd_code = newCode;						// update internal currently pressed code
+	if (kpd_code == kpd_sentCode)
+		return;
+
+	keypad_releaseSent();             // the key at the host is no longer the reported one
+	uint32_t mask = (uint32_t)1 << kpd_codeBit;
+	if (kpd_code && (kpd_fresh & mask)) { // first press, or a newer key took over
+		kpd_fresh   &= ~mask;
+		kpd_sentCode = kpd_code;
+		udi_hid_kbd_down(kpd_sentCode);
+		input_reportSent();
+	}                                 // falling back to a key held all along sends nothing
+}
+
+// release mode: down+up sent together once every key is released
+static void keypad_reportRelease(void)
+{
+	static bool    kpd_firstKey  = false;
+	static uint8_t kpd_firstCode = 0;
+	static bool    kpd_block     = false;
+
+	bool kpd_anyPressed = (kpd_keyPressed == KEYPAD_PRESSED);
+
+	if (!kpd_firstKey) {
+		if (kpd_anyPressed) {
+			kpd_firstKey = true;
+			kpd_firstCode = kpd_currentCode;
+			kpd_block = false;
 		}
 	} else {
-		if (kpd_keyPressed == KEYPAD_PRESSED) {
-			kpd_keyPressed = KEYPAD_RELEASED;
+		if (kpd_anyPressed && kpd_multiPress) {
+			if (kpd_multiPolicy == KEYPAD_MULTI_BLOCK)
+				kpd_block = true;
+			else if (kpd_multiPolicy == KEYPAD_MULTI_NEWEST)
+				kpd_firstCode = kpd_currentCode;
+		}
+		if (!kpd_anyPressed) {
+			if (!kpd_block) {
+				udi_hid_kbd_down(kpd_firstCode);
+				udi_hid_kbd_up(kpd_firstCode);
+				input_reportSent();
+			}
+			kpd_firstKey = false;
+			kpd_block = false;
 		}
 	}
-	kpd_multiPress = (pressedCount > 1);
 }
 
 // toggles LED's in test mode, sends HID code over USB in normal mode
 void keypad_report(void)
 {	
-	kpd_testMode = PORTB.IN;           // read test mode switch
+	kpd_testMode = input_getSnapshot()->testMode; // test mode switch as of the frame snapshot
 	kpd_currState = keypad_getState(); // feel like this one's select explanatory
 	kpd_currentCode = keypad_getCode();    // current code to be outputed
 
-	if ((kpd_testMode & 0x010) == 0)   // test mode enabled
+	if (kpd_testMode)                  // test mode enabled
 	{
+		keypad_releaseSent();          // nothing stays held at the host during test
+
 		// on press edge, toggle corresponding LED
 		if (kpd_currState == KEYPAD_PRESSED && kpd_prevState == KEYPAD_RELEASED)
 		{
-			uint8_t kpd_testMask = 0;
-			switch (kpd_currentCode) 
-			{
-				case HID_F1:        kpd_testMask = LED1_PIN;  break;  // F1
-				case HID_F2:        kpd_testMask = LED2_PIN;  break;  // F2
-				case HID_F3:        kpd_testMask = LED3_PIN;  break;  // F3
-				case HID_F4:        kpd_testMask = LED4_PIN;  break;  // F4
-				case HID_D:         kpd_testMask = LED5_PIN;  break;  // Display
-				case HID_ESCAPE:    kpd_testMask = LED6_PIN;  break;  // Cancel
-				case HID_ENTER:     kpd_testMask = LED7_PIN;  break;  // Enter
-				case HID_BACKSPACE:	kpd_testMask = LED8_PIN;  break;  // Clear
-				case HID_N:         kpd_testMask = LED1_PIN;  break;  // Null
-				default:            kpd_testMask = 0;         break;
-			}
+			uint8_t kpd_testMask = kpd_testLed[kpd_codeBit];
 			if (kpd_testMask) led_toggle(kpd_testMask);
 
 			kpd_exitTestMode = 1;	// flag for exiting test mode
 		}
 	}
-	else // normal mode
+	else if (kpd_reportMode == KEYPAD_REPORT_NKRO)
 	{
-		bool kpd_anyPressed = (keypad_getState() == KEYPAD_PRESSED);
-
-		static bool    kpd_firstKey  = false;
-		static uint8_t kpd_firstCode = 0;
-		static bool    kpd_block     = false;
-
-		if (!kpd_firstKey) {
-			if (kpd_anyPressed) {
-				kpd_firstKey = true;
-				kpd_firstCode = kpd_currentCode;
-				kpd_block = false;
-			}
-		} else {
-			if (kpd_anyPressed && !kpd_block && kpd_multiPress) {
-				kpd_block = true;
-			}
-			if (!kpd_anyPressed) {
-				if (!kpd_block) {
-					udi_hid_kbd_down(kpd_firstCode);
-					udi_hid_kbd_up(kpd_firstCode);
-				}
-				kpd_firstKey = false;
-				kpd_block = false;
-			}
-		}
+		keypad_reportNkro();
+	}
+	else if (kpd_reportMode == KEYPAD_REPORT_EDGE)
+	{
+		keypad_reportEdge();
+	}
+	else
+	{
+		keypad_reportRelease();
 	}
 
-	if (((kpd_testMode & 0x010) != 0) && (kpd_exitTestMode == 1)) {
+	if (!kpd_testMode && (kpd_exitTestMode == 1)) {
 		led_quiet_allOff();
 		kpd_exitTestMode = 0;
 	}
 	kpd_prevState = kpd_currState;
 }
 
+void keypad_setReportMode(uint8_t mode) {
+	if (mode > KEYPAD_REPORT_NKRO)
+		return;
+	keypad_releaseSent();
+	kpd_reportMode = mode;
+}
+uint8_t keypad_getReportMode(void) {
+	return kpd_reportMode;
+}
+void keypad_setMultiPolicy(uint8_t policy) {
+	if (policy > KEYPAD_MULTI_NEWEST)
+		return;
+	kpd_multiPolicy = policy;
+}
+uint8_t keypad_getMultiPolicy(void) {
+	return kpd_multiPolicy;
+}
 
-// get current map of keypad states
-uint16_t kbd_getMap(void) {
-	uint16_t bits = 0;
+/*
+ * replaces the keymap (NULL restores the flash defaults). takes effect at once,
+ * the EEPROM copy is written later by keypad_eepromTask() outside the interrupt.
+ * a map with a code past the keyboard report is refused, returns false.
+ */
+bool keypad_setKeymap(uint8_t const *map)
+{
+	if (map && !keypad_keymapValid(map))
+		return false;
+	keypad_releaseSent();                  // codes held at the host may change
 
-	for (uint8_t i = 0; i < 9; ++i) {
-		if (keyMap[i]) {
-			bits |= (1 << i);
-		}
+	if (map) {
+		memcpy(kpd_keymap, map, KEYPAD_KEYS);
+		kpd_keymapCustom = true;
+	} else {
+		for (uint8_t i = 0; i < KEYPAD_KEYS; ++i)
+			kpd_keymap[i] = PROGMEM_READ_BYTE(&kpd_defaultMap[i]);
+		kpd_keymapCustom = false;
 	}
+	if (kpd_view)
+		keypad_select(kpd_codeBit);
+	kpd_keymapDirty = true;
+	return true;
+}
+
+// copies the keymap, returns true if it is an EEPROM override
+bool keypad_getKeymap(uint8_t *map)
+{
+	memcpy(map, kpd_keymap, KEYPAD_KEYS);
+	return kpd_keymapCustom;
+}
+
+// writes a pending keymap change to EEPROM (slow, call from the main loop)
+void keypad_eepromTask(void)
+{
+	keymap_record_t rec;
+
+	if (!kpd_keymapDirty)
+		return;
 
-	return bits;
-}
\ No newline at end of file
+	irqflags_t flags = cpu_irq_save();
+	kpd_keymapDirty = false;
+	memcpy(rec.map, kpd_keymap, KEYPAD_KEYS);
+	rec.magic = kpd_keymapCustom ? KEYMAP_MAGIC : 0xFF;   // defaults: invalidate the record
+	cpu_irq_restore(flags);
+
+	rec.check = keypad_keymapCheck(rec.map);
+	nvm_eeprom_erase_and_write_buffer(CONFIG_KEYPAD_KEYMAP_EEPROM, &rec, sizeof(rec));
+}
+
+
+// get current map of keypad states (bit order of KEY_NAMES in EVi_FrontPanel_GUI.py)
+uint16_t kbd_getMap(uint32_t m) { // GUI key bits from a matrix (the frame snapshot)
+	uint8_t c01 = (uint8_t)(m);       // col 0 (bits 0-3), col 1 (bits 4-7)
+	uint8_t c23 = (uint8_t)(m >> 8);  // col 2 (bits 0-3), col 3 (bits 4-7)
+	uint8_t c4  = (uint8_t)(m >> 16); // col 4 (bits 0-3)
+
+	uint8_t lo = ((c23 >> 6) & 0x01)  // F1      (col 3, row 2) -> bit 0
+	           | ((c4  >> 1) & 0x02)  // F2      (col 4, row 2) -> bit 1
+	           | ((c23 >> 5) & 0x04)  // F3      (col 3, row 3) -> bit 2
+	           | ( c4        & 0x08)  // F4      (col 4, row 3) -> bit 3
+	           | ((c23 << 4) & 0x10)  // Display (col 2, row 0) -> bit 4
+	           | ( c01       & 0x20)  // CANCEL  (col 1, row 1) -> bit 5
+	           | ((c01 << 2) & 0x40)  // ENTER   (col 1, row 0) -> bit 6
+	           | ((c01 << 6) & 0x80); // CLEAR   (col 0, row 1) -> bit 7
+	uint8_t hi =   c01       & 0x01;  // NULL    (col 0, row 0) -> bit 8
+
+	return ((uint16_t)hi << 8) | lo;
+}
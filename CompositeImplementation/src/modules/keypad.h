@@ -7,16 +7,41 @@
 
 #define KEYPAD_COLS		 5
 #define KEYPAD_ROWS		 4
+#define KEYPAD_KEYS		(KEYPAD_COLS * KEYPAD_ROWS)
+
+#define KEYPAD_REPORT_EDGE      0   // down on press, up on release
+#define KEYPAD_REPORT_RELEASE   1   // down+up after release
+#define KEYPAD_REPORT_NKRO      2   // whole held set, once per frame
+
+#define KEYPAD_MULTI_BLOCK      0   // chords send nothing
+#define KEYPAD_MULTI_FIRST      1   // first key held wins
+#define KEYPAD_MULTI_NEWEST     2   // newest key pressed wins
 
 void keypad_init        (void);
 
 uint8_t keypad_getState (void);
 uint8_t keypad_getCode  (void);
 
-void keypad_poll        (void);
+uint32_t keypad_poll    (void);
+void keypad_event       (uint8_t bit, bool pressed);
+void keypad_sync        (void);
 void keypad_report      (void);
 
-uint16_t kbd_getMap     (void);
+void    keypad_setReportMode  (uint8_t mode);
+uint8_t keypad_getReportMode  (void);
+void    keypad_setMultiPolicy (uint8_t policy);
+uint8_t keypad_getMultiPolicy (void);
+
+bool    keypad_setKeymap      (uint8_t const *map);
+bool    keypad_getKeymap      (uint8_t *map);
+void    keypad_eepromTask     (void);
+
+bool keypad_arm         (void);
+void keypad_disarm      (void);
+
+uint32_t keypad_getMatrix (void);
+uint32_t keypad_getView   (void);
+uint16_t kbd_getMap     (uint32_t matrix);
 
 
 #endif
\ No newline at end of file
@@ -3,17 +3,19 @@
  *
  * Author: Jackson Clary
  * Purpose: Initialize and drive all front‐panel LEDs (on/off/toggle), 
- *          maintain a software LED state map, and implement startup/idle
- *          animation sequences in response to user activity.
+ *          maintain a software LED state map, and implement the startup
+ *          sequence (idle & other animations run as scripts, see script.c).
  *
  * History:
  *   Created June 9, 2025
  */
 
 #include <asf.h>
-#include <util/delay.h>
+#include "conf_led.h"
 
 #include "led.h"
+#include "bam.h"
+#include "fade.h"
 #include "keypad.h"
 #include "joystick.h"
 
@@ -26,20 +28,21 @@ static void led_quiet_allOn(void);
 // static void led_quiet_on(uint8_t mask);
 // static void led_quiet_off(uint8_t mask);
 // static void led_quiet_toggle(uint8_t mask);
-static void led_quiet_setState(uint8_t mask);
 
-static bool ledMap[16] = {0}; // map of current LED states
-static void led_updateState(uint8_t mask, bool state); // update bitmap
+// lit LEDs: bits 0-7 LED1-8 (PORTA.OUT inverted, the pins are active low), bit 8 status,
+// the same layout the BAM planes and the GUI report use
+static uint16_t ledShadow;
+static void led_updateState(uint16_t mask, bool state); // update shadow
+
+#define STARTUP_ON    0       // every LED lit
+#define STARTUP_OFF   1       // dark pause before the panel is handed over
+#define STARTUP_DONE  2
 
 typedef struct {
-    bool     running; // idle sequence active or not
-    uint8_t  stage;   // current stage of accel
-    uint8_t  pass;    // # of passes through all LEDs
-    uint8_t  step;    // current LED (0-7)
-    uint16_t timer;   // timer between steps
-    uint16_t period;  // delay for advancing steps
-} idle_t;
-static idle_t idle = {0};
+    uint8_t  stage;
+    uint16_t timer;   // ms left in the stage
+} startup_t;
+static startup_t startup = { .stage = STARTUP_DONE };
 
 
 /* ---------------------------------------------------------------------- */
@@ -51,54 +54,48 @@ void led_init(void) {
 
     STATUS_LED_PORT.DIRSET = LEDS_PIN;
     STATUS_LED_PORT.OUTSET = LEDS_PIN;
+
+    bam_init();
 }
 
 void led_allOn(void) {			  // turns all LED's on
-	LED_PORT.OUTCLR = LED_MASK;
+    fade_setMask(LED_MASK, LED_MASK);
 
     led_updateState(LED_MASK, true);
     activityEnable();
 }
 
 void led_allOff(void) {           // turns all LED's off
-	LED_PORT.OUTSET = LED_MASK;
+    fade_setMask(LED_MASK, 0);
 
     led_updateState(LED_MASK, false);
     activityEnable();
 }
 
 void led_on(uint8_t mask) {	      // LED on
-    LED_PORT.OUTCLR = mask;       // drive low (on)
+    fade_setMask(mask, mask);     // full brightness
 
     led_updateState(mask, true);
     activityEnable();
 }
 
 void led_off(uint8_t mask) {      // LED off
-    LED_PORT.OUTSET = mask;       // drive high (off)
+    fade_setMask(mask, 0);
 
     led_updateState(mask, false);
     activityEnable();
 }
 
 void led_toggle(uint8_t mask) {   // toggle LED
-    LED_PORT.OUTTGL = mask;
-
-    for (int i = 0; i < 8; i++) {
-        if (mask & (1 << i)) {
-            ledMap[i] = !ledMap[i];
-        }
-    }
+    ledShadow ^= mask;
+    fade_setMask(mask, ledShadow);
     activityEnable();
 }
 
 void led_setState(uint8_t mask) { // sets LEDs to on
-    LED_PORT.OUTSET = LED_MASK;
-    LED_PORT.OUTCLR = mask;
+    fade_setMask(LED_MASK, mask);
 
-    for (int i = 0; i < 8; i++) {
-        ledMap[i] = (mask & (1 << i)) != 0;
-    }
+    ledShadow = (ledShadow & ~LED_MASK) | mask;
     activityEnable();
 }
 
@@ -107,46 +104,45 @@ void led_setState(uint8_t mask) { // sets LEDs to on
 /* ------------------------- silent LED control ------------------------- */
 /* ---------------------------------------------------------------------- */
 static void led_quiet_allOn(void) {   // turns all LED's on
-    LED_PORT.OUTCLR = LED_MASK;
+    fade_setMask(LED_MASK, LED_MASK);
 
     led_updateState(LED_MASK, true);
 }
 
 void led_quiet_allOff(void) {         // turns all LED's off
-    LED_PORT.OUTSET = LED_MASK;
+    fade_setMask(LED_MASK, 0);
 
     led_updateState(LED_MASK, false);
 }
 
 // static void led_quiet_on(uint8_t mask) {     // LED on
-//     LED_PORT.OUTCLR = mask;     // drive low (on)
+//     fade_setMask(mask, mask);   // full brightness
 
 //     led_updateState(mask, true);
 // }
 
 // static void led_quiet_off(uint8_t mask) {    // LED off
-//     LED_PORT.OUTSET = mask;     // drive high (off)
+//     fade_setMask(mask, 0);
 
 //     led_updateState(mask, false);
 // }
 
 // static void led_quiet_toggle(uint8_t mask) { // toggle LED
-//     LED_PORT.OUTTGL = mask;
-
-//     for (int i = 0; i < 8; i++) {
-//         if (mask & (1 << i)) {
-//             ledMap[i] = !ledMap[i];
-//         }
-//     }
+//     ledShadow ^= mask;
+//     fade_setMask(mask, ledShadow);
 // }
 
-static void led_quiet_setState(uint8_t mask) { // sets LEDs to on
-    LED_PORT.OUTSET = LED_MASK;
-    LED_PORT.OUTCLR = mask;
+void led_quiet_crossFade(uint8_t mask, uint16_t ms) { // fades mask in, the rest out
+    fade_cross(LED_MASK & ~mask, mask, ms);
 
-    for (int i = 0; i < 8; i++) {
-        ledMap[i] = (mask & (1 << i)) != 0;
-    }
+    ledShadow = (ledShadow & ~LED_MASK) | mask;
+}
+
+
+void led_quiet_breathe(uint8_t mask, uint16_t periodMs) { // mask breathes, the rest keep their level
+    fade_breathe(mask, periodMs);
+
+    led_updateState(mask, true);
 }
 
 
@@ -154,106 +150,93 @@ static void led_quiet_setState(uint8_t mask) { // sets LEDs to on
 /* ------------------------- status LED control ------------------------- */
 /* ---------------------------------------------------------------------- */
 void led_statusOn(void) { // status LED on
-    STATUS_LED_PORT.OUTCLR = LEDS_PIN;
+    fade_setMask(BAM_STATUS, BAM_STATUS);
 
-    ledMap[8] = true;
+    led_updateState(BAM_STATUS, true);
 }
 
 void led_statusOff(void) { // status LED off
-    STATUS_LED_PORT.OUTSET = LEDS_PIN;
+    fade_setMask(BAM_STATUS, 0);
 
-    ledMap[8] = false;
+    led_updateState(BAM_STATUS, false);
 }
 
 void led_statusToggle(void) { // toggle status LED
-    STATUS_LED_PORT.OUTTGL = LEDS_PIN;
+    ledShadow ^= BAM_STATUS;
+
+    fade_setMask(BAM_STATUS, ledShadow);
+}
+
+void led_statusLevel(uint8_t level) { // status LED at a perceived level
+    fade_set(BAM_STATUS, level);
+
+    led_updateState(BAM_STATUS, level != 0);
+}
+
+void led_statusBreathe(uint16_t periodMs) { // status LED breathing, until the next on/off
+    fade_breathe(BAM_STATUS, periodMs);
 
-    ledMap[8] = !ledMap[8];
+    led_updateState(BAM_STATUS, true);
 }
 
 
 /* ---------------------------------------------------------------------- */
-/* ---------------------------- LED state map --------------------------- */
+/* ----------------------------- brightness ----------------------------- */
 /* ---------------------------------------------------------------------- */
-static void led_updateState(uint8_t mask, bool state) {
-    for (int i = 0; i < 8; i++) {
-        if (mask & (1 << i)) {
-            ledMap[i] = state;
-        }
-    }
+void led_setLevel(uint16_t mask, uint8_t level) { // mask bit 8 = status LED, perceived 0 = off, 255 = on
+    fade_set(mask, level);
+
+    led_updateState(mask, level != 0);
+    activityEnable();
 }
 
-uint16_t led_getMap(void) {
-    uint16_t map = 0;
-    for (uint8_t i = 0; i < 16; i++) {
-        if (ledMap[i]) {
-            map |= (1 << i);
-        }
-    }
-    return map;
+uint8_t led_getLevel(uint8_t led) { // 0-7 LED1-8, 8 status
+    return fade_level(led);
 }
 
 
 /* ---------------------------------------------------------------------- */
-/* --------------------------- startup & idle --------------------------- */
+/* ---------------------------- LED state map --------------------------- */
 /* ---------------------------------------------------------------------- */
-bool startupSequence(void) {
-    led_quiet_allOn();
-    led_statusOn();
-    _delay_ms(15000);
-    led_quiet_allOff();
-    led_statusOff();
-    _delay_ms(2500);
-
-    return 0;
+static void led_updateState(uint16_t mask, bool state) {
+    ledShadow = state ? (ledShadow | mask) : (ledShadow & ~mask);
 }
 
-void idleStart(void) {
-    idle.running   = true;
-    idle.stage     = 0;
-    idle.pass      = 0;
-    idle.step      = 0;
-    idle.timer     = 0;
-    idle.period    = 250;
+uint16_t led_getMap(void) { // GUI report bits, straight from the shadow
+    return ledShadow;
 }
-void idleStop(void) {
-    idle.running = false;
-    led_quiet_allOff();
+
+
+/* ---------------------------------------------------------------------- */
+/* ------------------------------- startup ------------------------------ */
+/* ---------------------------------------------------------------------- */
+void startupStart(void) {
+    if (!CONFIG_LED_STARTUP_ON_MS && !CONFIG_LED_STARTUP_OFF_MS)
+        return;                             // configured out
+    startup.stage = STARTUP_ON;
+    startup.timer = CONFIG_LED_STARTUP_ON_MS;
+    led_quiet_allOn();
+    led_statusOn();
 }
-void idlePoll(void) {
-    if (!idle.running)
-        return;
-    if (activityCheck()) {
-        idleStop();
-        return;
+bool startupPoll(void) { // once per ms, true while the sequence runs
+    if (startup.stage == STARTUP_DONE)
+        return false;
+    if (activityCheck()) {                  // host took the LEDs over, leave them as set
+        startup.stage = STARTUP_DONE;
+        return false;
     }
 
-    if (++idle.timer < idle.period)
-        return;
-    idle.timer = 0;
-
-    if (idle.step >= 8) {
-        idle.step = 0;
-
-        if (idle.stage == 0) {
-            idle.pass++;
-
-            if (idle.period > 100) {
-                idle.period -= 75;
-            } else {
-                idle.period = 50;
-            }
-            if (idle.pass >= 4) {
-                idle.stage = 1;
-                idle.period = 50;
-            }
-        }
+    if (startup.timer) {
+        startup.timer--;
+        return true;
     }
-
-    led_quiet_setState(1 << idle.step);
-    idle.step++;
+    if (startup.stage == STARTUP_ON) {
+        startup.stage = STARTUP_OFF;
+        startup.timer = CONFIG_LED_STARTUP_OFF_MS;
+        led_quiet_allOff();
+        led_statusOff();
+        return true;
+    }
+    startup.stage = STARTUP_DONE;
+    return false;
 }
-
-bool idleStatus(void) {
-    return idle.running;
-}
\ No newline at end of file
@@ -39,6 +39,8 @@ void led_setState     (uint8_t mask);
 /* -------- silent LED control ------- */
 // void led_quiet_allOn  (void);
 void led_quiet_allOff (void);
+void led_quiet_crossFade(uint8_t mask, uint16_t ms);
+void led_quiet_breathe  (uint8_t mask, uint16_t periodMs);
 // void led_quiet_on     (uint8_t mask);
 // void led_quiet_off    (uint8_t mask);
 // void led_quiet_toggle (uint8_t mask);
@@ -48,19 +50,22 @@ void led_quiet_allOff (void);
 void led_statusOn     (void);
 void led_statusOff    (void);
 void led_statusToggle (void);
+void led_statusLevel  (uint8_t level);
+void led_statusBreathe(uint16_t periodMs);
+
+
+/* ------------ brightness ----------- */
+void    led_setLevel  (uint16_t mask, uint8_t level);
+uint8_t led_getLevel  (uint8_t led);
 
 
 /* ---------- LED state map ---------- */
 uint16_t led_getMap   (void);
 
 
-/* ---------- startup & idle --------- */
-bool startupSequence  (void);
-
-void idleStart        (void);
-void idleStop         (void);
-void idlePoll         (void);
-bool idleStatus       (void);
+/* ------------- startup ------------- */
+void startupStart     (void);
+bool startupPoll      (void);
 
 
 #endif
\ No newline at end of file
@@ -0,0 +1,98 @@
+/*
+ * sampler.c – DMA oversampling of the slider ports for the EVi Classic firmware
+ *
+ * Purpose: Let TCC1 overflow events trigger one DMA byte copy per port from PORTC/D/E/B.IN into
+ *          a small SRAM ring, SAMPLER_DEPTH times per scanner tick, without any interrupt.
+ *          The scanner tick then majority-votes the newest batch of each port, so a glitch
+ *          shorter than half a tick never reaches the debouncer.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include "conf_input.h"
+
+#include "sampler.h"
+
+#define SAMPLER_HZ  ((uint32_t)CONFIG_INPUT_SCAN_HZ * SAMPLER_DEPTH)
+
+// each ring holds exactly one tick of samples, so voting the whole ring votes the newest batch
+static volatile uint8_t sampler_ring[SAMPLER_PORTS][SAMPLER_DEPTH];
+
+static void sampler_channel(volatile DMA_CH_t *ch, volatile uint8_t *src, volatile uint8_t *dst) {
+	uint16_t from = (uintptr_t)src;
+	uint16_t to   = (uintptr_t)dst;
+
+	ch->CTRLA     = 0;
+	ch->ADDRCTRL  = DMA_CH_SRCRELOAD_NONE_gc  | DMA_CH_SRCDIR_FIXED_gc |   // same IN register
+	                DMA_CH_DESTRELOAD_BLOCK_gc | DMA_CH_DESTDIR_INC_gc;    // wrap after the ring
+	ch->TRIGSRC   = DMA_CH_TRIGSRC_EVSYS_CH0_gc;
+	ch->TRFCNT    = SAMPLER_DEPTH;
+	ch->REPCNT    = 0;                                                     // repeat forever
+	ch->SRCADDR0  = (uint8_t)from;
+	ch->SRCADDR1  = (uint8_t)(from >> 8);
+	ch->SRCADDR2  = 0;
+	ch->DESTADDR0 = (uint8_t)to;
+	ch->DESTADDR1 = (uint8_t)(to >> 8);
+	ch->DESTADDR2 = 0;
+	ch->CTRLA     = DMA_CH_ENABLE_bm | DMA_CH_REPEAT_bm | DMA_CH_SINGLE_bm |  // one byte per event
+	                DMA_CH_BURSTLEN_1BYTE_gc;
+}
+
+void sampler_init(void) {
+	uint8_t i, p;
+
+	for (p = 0; p < SAMPLER_PORTS; p++)         // released until the first samples land
+		for (i = 0; i < SAMPLER_DEPTH; i++)
+			sampler_ring[p][i] = 0xFF;
+
+	sysclk_enable_module(SYSCLK_PORT_GEN, SYSCLK_DMA);
+	sysclk_enable_module(SYSCLK_PORT_GEN, SYSCLK_EVSYS);
+	sysclk_enable_module(SYSCLK_PORT_C, SYSCLK_TC1);
+
+	DMA.CTRL = DMA_ENABLE_bm;
+	sampler_channel(&DMA.CH0, &PORTC.IN, sampler_ring[SAMPLER_PORT_C]);
+	sampler_channel(&DMA.CH1, &PORTD.IN, sampler_ring[SAMPLER_PORT_D]);
+	sampler_channel(&DMA.CH2, &PORTE.IN, sampler_ring[SAMPLER_PORT_E]);
+	sampler_channel(&DMA.CH3, &PORTB.IN, sampler_ring[SAMPLER_PORT_B]);
+
+	EVSYS.CH0MUX = EVSYS_CHMUX_TCC1_OVF_gc;
+	TCC1.CTRLB   = TC_WGMODE_NORMAL_gc;
+	TCC1.PER     = (sysclk_get_per_hz() / SAMPLER_HZ) - 1;
+	sampler_start();
+}
+
+void sampler_start(void) {
+	TCC1.CNT   = 0;
+	TCC1.CTRLA = TC_CLKSEL_DIV1_gc;
+}
+
+void sampler_stop(void) { // DMA channels stay armed, they just get no more events
+	TCC1.CTRLA = TC_CLKSEL_OFF_gc;
+}
+
+// bitwise majority of the port's last SAMPLER_DEPTH samples, ties read high (released)
+uint8_t sampler_vote(uint8_t port) {
+	volatile uint8_t *r = sampler_ring[port];
+	uint8_t all = 0xFF, any = 0;
+	uint8_t s0 = 0, s1 = 0, s2 = 0, s3 = 0, c;
+	uint8_t i, b;
+
+	for (i = 0; i < SAMPLER_DEPTH; i++) {
+		b    = r[i];
+		all &= b;
+		any |= b;
+	}
+	if (all == any)                             // steady, nothing to vote
+		return all;
+
+	for (i = 0; i < SAMPLER_DEPTH; i++) {       // bit-sliced count of the ones, 0-8
+		b   = r[i];
+		c   = s0 & b;  s0 ^= b;
+		b   = s1 & c;  s1 ^= c;
+		c   = s2 & b;  s2 ^= b;
+		s3 |= c;
+	}
+	return s2 | s3;                             // ones >= 4
+}
@@ -0,0 +1,19 @@
+#ifndef SAMPLER_H
+#define SAMPLER_H
+
+
+#define SAMPLER_PORT_C     0   // vertical slider C2-C7
+#define SAMPLER_PORT_D     1   // vertical slider D0-D5
+#define SAMPLER_PORT_E     2   // horizontal slider E0-E7
+#define SAMPLER_PORT_B     3   // horizontal slider B0-B3
+#define SAMPLER_PORTS      4
+
+#define SAMPLER_DEPTH      8   // samples per port per scanner tick
+
+void    sampler_init  (void);
+void    sampler_start (void);
+void    sampler_stop  (void);
+uint8_t sampler_vote  (uint8_t port);
+
+
+#endif
@@ -0,0 +1,327 @@
+/*
+ * script.c – LED animation scripts for the EVi Classic firmware
+ *
+ * Purpose: Run LED animations written in a small bytecode (set, fade, wait, loop, branch on
+ *          activity) from the 1 ms tick, at most CONFIG_LED_SCRIPT_OPS instructions per tick.
+ *          Built-in scripts live in flash; one more can be uploaded by the host into RAM and
+ *          kept in EEPROM, so new panel behaviour ships without reflashing.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include <string.h>
+#include "conf_led.h"
+
+#include "led.h"
+#include "ui.h"
+#include "script.h"
+#include "stats.h"
+
+#define SCR_NO_ADDR   0xFF
+
+// uploaded script kept in EEPROM, loaded into the RAM slot at power-up while valid
+#define SCRIPT_MAGIC  0x53  // 'S'
+
+typedef struct {
+	uint8_t magic;
+	uint8_t len;
+	uint8_t idle;          // played by the host START command instead of SCRIPT_IDLE
+	uint8_t code[CONFIG_LED_SCRIPT_SIZE];
+	uint8_t check;         // complement of the byte sum of len, idle & code[]
+} script_record_t;
+
+#define SCR_STEP(mask, ms)  SCR_FADE, (mask), SCR_MS(ms), SCR_WAIT, SCR_MS(ms)
+
+// same passes as the former idlePoll: 8 steps each at 250, 175, 100 ms, then 50 ms for good
+static PROGMEM_DECLARE(uint8_t, scr_idle[]) = {
+	SCR_LOOP, 8, SCR_CHASE, SCR_MS(250), SCR_NEXT,          //  0
+	SCR_LOOP, 8, SCR_CHASE, SCR_MS(175), SCR_NEXT,          //  6
+	SCR_LOOP, 8, SCR_CHASE, SCR_MS(100), SCR_NEXT,          // 12
+	SCR_CHASE, SCR_MS(50),                                  // 18
+	SCR_JUMP, 18,
+};
+
+static PROGMEM_DECLARE(uint8_t, scr_pulse[]) = {
+	SCR_BREATHE, 0xFF, SCR_MS(2000),                        //  0
+	SCR_WAIT, SCR_MS(60000),                                //  4
+	SCR_JUMP, 4,
+};
+
+static PROGMEM_DECLARE(uint8_t, scr_sweep[]) = {
+	SCR_STEP(0x01, 80), SCR_STEP(0x02, 80), SCR_STEP(0x04, 80), SCR_STEP(0x08, 80),
+	SCR_STEP(0x10, 80), SCR_STEP(0x20, 80), SCR_STEP(0x40, 80), SCR_STEP(0x80, 80),
+	SCR_STEP(0x40, 80), SCR_STEP(0x20, 80), SCR_STEP(0x10, 80), SCR_STEP(0x08, 80),
+	SCR_STEP(0x04, 80), SCR_STEP(0x02, 80),
+	SCR_JUMP, 0,
+};
+
+typedef struct {
+	uint8_t const *code;   // flash address
+	uint8_t        len;
+} scr_builtin_t;
+
+static const scr_builtin_t scr_builtin[SCRIPT_BUILTIN] = {
+	{ scr_idle,  sizeof(scr_idle)  },
+	{ scr_pulse, sizeof(scr_pulse) },
+	{ scr_sweep, sizeof(scr_sweep) },
+};
+
+typedef struct {
+	uint8_t  id;           // SCRIPT_NONE while stopped
+	uint8_t  len;
+	uint8_t  pc;
+	uint16_t wait;         // ms left of a pause
+	uint8_t  onAct;        // SCR_ONACT target, SCR_NO_ADDR for stop
+	bool     active;       // activity seen on the last tick, branches are taken on the edge
+	uint8_t  cursor;       // last LED lit by SCR_CHASE
+	uint8_t  sp;
+	uint8_t  loopPc[CONFIG_LED_SCRIPT_DEPTH];
+	uint8_t  loopLeft[CONFIG_LED_SCRIPT_DEPTH];   // 0 = forever
+	bool     fault;
+} scr_state_t;
+
+static scr_state_t   scr = { .id = SCRIPT_NONE };
+
+static uint8_t       scr_user[CONFIG_LED_SCRIPT_SIZE];   // uploaded script
+static uint8_t       scr_userLen;
+static bool          scr_userIdle;                      // START plays the uploaded script
+static bool          scr_userSaved;                     // scr_user matches the EEPROM record
+static volatile bool scr_userDirty;                     // EEPROM write pending
+
+
+static uint8_t scr_check(uint8_t const *rec) { // rec = &len, len + idle + code
+	uint8_t sum = 0;
+
+	for (uint8_t i = 0; i < 2 + CONFIG_LED_SCRIPT_SIZE; i++)
+		sum += rec[i];
+	return ~sum;
+}
+
+// loads a valid EEPROM record into the RAM slot
+void script_init(void) {
+	script_record_t rec;
+
+	nvm_eeprom_read_buffer(CONFIG_LED_SCRIPT_EEPROM, &rec, sizeof(rec));
+	if (rec.magic == SCRIPT_MAGIC && rec.len <= CONFIG_LED_SCRIPT_SIZE &&
+	    rec.check == scr_check(&rec.len)) {
+		memcpy(scr_user, rec.code, CONFIG_LED_SCRIPT_SIZE);
+		scr_userLen   = rec.len;
+		scr_userIdle  = rec.idle;
+		scr_userSaved = true;
+	}
+}
+
+
+/* ---------------------------------------------------------------------- */
+/* ----------------------------- interpreter ---------------------------- */
+/* ---------------------------------------------------------------------- */
+void script_run(uint8_t id) {
+	uint8_t len;
+
+	if (id < SCRIPT_BUILTIN)
+		len = scr_builtin[id].len;
+	else if (id == SCRIPT_USER && scr_userLen)
+		len = scr_userLen;
+	else
+		return;
+
+	memset(&scr, 0, sizeof(scr));
+	scr.id     = id;
+	scr.len    = len;
+	scr.onAct  = SCR_NO_ADDR;
+	scr.active = activityCheck();
+	scr.cursor = 7;                            // first SCR_CHASE lights LED1
+}
+
+void script_runIdle(void) { // what the host START command plays
+	script_run(scr_userIdle ? SCRIPT_USER : SCRIPT_IDLE);
+}
+
+void script_stop(void) {
+	scr.id = SCRIPT_NONE;
+}
+
+bool script_running(void) {
+	return scr.id != SCRIPT_NONE;
+}
+
+static uint8_t scr_byte(void) { // next script byte, running off the end is a fault
+	if (scr.pc >= scr.len) {
+		scr.fault = true;
+		return SCR_END;
+	}
+	if (scr.id == SCRIPT_USER)
+		return scr_user[scr.pc++];
+	return PROGMEM_READ_BYTE(&scr_builtin[scr.id].code[scr.pc++]);
+}
+
+static uint16_t scr_ms(void) {
+	uint16_t ms = scr_byte();
+	return ms | ((uint16_t)scr_byte() << 8);
+}
+
+static void scr_goto(uint8_t addr) {
+	if (addr >= scr.len)
+		scr.fault = true;
+	else
+		scr.pc = addr;
+}
+
+// one instruction, false once the tick should end (pause or stop)
+static bool scr_step(void) {
+	uint8_t  op = scr_byte();
+	uint8_t  mask, n;
+	uint16_t ms;
+
+	switch (op) {
+	case SCR_END:
+		script_stop();
+		return false;
+	case SCR_SET:
+		led_quiet_crossFade(scr_byte(), 0);
+		break;
+	case SCR_FADE:
+		mask = scr_byte();
+		led_quiet_crossFade(mask, scr_ms());
+		break;
+	case SCR_WAIT:
+		scr.wait = scr_ms();
+		return false;
+	case SCR_LOOP:
+		n = scr_byte();
+		if (scr.sp >= CONFIG_LED_SCRIPT_DEPTH) {
+			scr.fault = true;
+			break;
+		}
+		scr.loopPc  [scr.sp] = scr.pc;
+		scr.loopLeft[scr.sp] = n;
+		scr.sp++;
+		break;
+	case SCR_NEXT:
+		if (!scr.sp) {
+			scr.fault = true;
+			break;
+		}
+		n = scr.loopLeft[scr.sp - 1];
+		if (n == 1) {                          // last pass, fall through
+			scr.sp--;
+		} else {
+			if (n)
+				scr.loopLeft[scr.sp - 1] = n - 1;
+			scr.pc = scr.loopPc[scr.sp - 1];
+		}
+		break;
+	case SCR_JUMP:
+		scr_goto(scr_byte());
+		break;
+	case SCR_ONACT:
+		scr.onAct = scr_byte();
+		break;
+	case SCR_CHASE:
+		ms = scr_ms();
+		scr.cursor = (scr.cursor + 1) & 7;
+		led_quiet_crossFade(1u << scr.cursor, ms);
+		scr.wait = ms;
+		return false;
+	case SCR_BREATHE:
+		mask = scr_byte();
+		led_quiet_breathe(mask, scr_ms());
+		break;
+	case SCR_STATUS:
+		led_statusLevel(scr_byte());
+		break;
+	default:
+		scr.fault = true;
+		break;
+	}
+	return true;
+}
+
+// 1 ms: at most CONFIG_LED_SCRIPT_OPS instructions, a script that never pauses just runs slower
+void script_tick(void) {
+	bool    act;
+	uint8_t ops = 0;
+
+	if (scr.id == SCRIPT_NONE)
+		return;
+
+	act = activityCheck();
+	if (act && !scr.active) {                  // host took the LEDs
+		if (scr.onAct == SCR_NO_ADDR) {
+			script_stop();
+			return;
+		}
+		scr_goto(scr.onAct);
+		scr.onAct = SCR_NO_ADDR;
+		scr.wait  = 0;
+	}
+	scr.active = act;
+
+	if (scr.wait && --scr.wait)
+		return;
+
+	while ((ops < CONFIG_LED_SCRIPT_OPS) && !scr.fault) {
+		ops++;
+		if (!scr_step())
+			break;
+	}
+	if (ops > stats.scriptOpsMax)
+		stats.scriptOpsMax = ops;
+	if (scr.fault) {                           // bad opcode, jump or loop nesting
+		stats.scriptFaults++;
+		script_stop();
+	}
+}
+
+
+/* ---------------------------------------------------------------------- */
+/* ------------------------------ host slot ----------------------------- */
+/* ---------------------------------------------------------------------- */
+// replaces the RAM slot, checked for size only (bad code faults when it runs)
+bool script_load(uint8_t const *code, uint8_t len) {
+	if (len > CONFIG_LED_SCRIPT_SIZE)
+		return false;
+	if (scr.id == SCRIPT_USER)
+		script_stop();
+	memset(scr_user, SCR_END, CONFIG_LED_SCRIPT_SIZE);
+	memcpy(scr_user, code, len);
+	scr_userLen   = len;
+	scr_userSaved = false;
+	return true;
+}
+
+// keeps the RAM slot in EEPROM, idle: START plays it instead of SCRIPT_IDLE (written by script_eepromTask)
+void script_save(bool idle) {
+	scr_userIdle  = idle && scr_userLen;
+	scr_userDirty = true;
+}
+
+// running id, pc, slot length, slot flags (bit 0 saved, bit 1 plays as idle)
+void script_getStatus(uint8_t *buf) {
+	buf[0] = scr.id;
+	buf[1] = scr.pc;
+	buf[2] = scr_userLen;
+	buf[3] = (scr_userSaved ? 1 : 0) | (scr_userIdle ? 2 : 0);
+}
+
+// writes a pending slot save to EEPROM (slow, call from the main loop)
+void script_eepromTask(void) {
+	script_record_t rec;
+
+	if (!scr_userDirty)
+		return;
+
+	irqflags_t flags = cpu_irq_save();
+	scr_userDirty = false;
+	memcpy(rec.code, scr_user, CONFIG_LED_SCRIPT_SIZE);
+	rec.len   = scr_userLen;
+	rec.idle  = scr_userIdle;
+	rec.magic = scr_userLen ? SCRIPT_MAGIC : 0xFF;       // empty slot: invalidate the record
+	scr_userSaved = true;
+	cpu_irq_restore(flags);
+
+	rec.check = scr_check(&rec.len);
+	nvm_eeprom_erase_and_write_buffer(CONFIG_LED_SCRIPT_EEPROM, &rec, sizeof(rec));
+}
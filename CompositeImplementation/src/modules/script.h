@@ -0,0 +1,43 @@
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+
+/*
+ * bytecode, one opcode byte then its arguments (ms are 16 bit little endian, addr is a byte
+ * offset into the script). LED masks are LED1-8, the status LED has its own op.
+ */
+#define SCR_END        0x00    //                 stop, LEDs stay as they are
+#define SCR_SET        0x01    // mask            mask on, the rest off
+#define SCR_FADE       0x02    // mask ms         crossfade to mask
+#define SCR_WAIT       0x03    // ms              pause
+#define SCR_LOOP       0x04    // n               run up to SCR_NEXT n times (0 = forever)
+#define SCR_NEXT       0x05    //
+#define SCR_JUMP       0x06    // addr
+#define SCR_ONACT      0x07    // addr            on host LED activity go to addr (default: stop)
+#define SCR_CHASE      0x08    // ms              crossfade to the next single LED, then pause
+#define SCR_BREATHE    0x09    // mask ms         mask breathes with period ms
+#define SCR_STATUS     0x0A    // level           status LED, perceived 0-255
+
+#define SCR_MS(ms)     (uint8_t)(ms), (uint8_t)((uint16_t)(ms) >> 8)
+
+#define SCRIPT_IDLE    0       // accelerating chase (the former idlePoll)
+#define SCRIPT_PULSE   1       // every LED breathing
+#define SCRIPT_SWEEP   2       // single LED gliding back and forth
+#define SCRIPT_BUILTIN 3
+#define SCRIPT_USER    0x80    // host-uploaded slot
+#define SCRIPT_NONE    0xFF
+
+void    script_init       (void);
+void    script_run        (uint8_t id);
+void    script_runIdle    (void);
+void    script_stop       (void);
+void    script_tick       (void);
+bool    script_running    (void);
+
+bool    script_load       (uint8_t const *code, uint8_t len);
+void    script_save       (bool idle);
+void    script_getStatus  (uint8_t *buf);
+void    script_eepromTask (void);
+
+
+#endif
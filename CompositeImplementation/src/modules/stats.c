@@ -0,0 +1,61 @@
+/*
+ * stats.c – Runtime statistics for the EVi Classic firmware
+ *
+ * Purpose: Hold the counters the input, keyboard and LED code update at runtime and
+ *          serialize them for the host through the LED interface feature report.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include <string.h>
+
+#include "stats.h"
+#include "timebase.h"
+
+stats_t stats;
+
+
+// bootReport survives: it is measured once per power-up and can't be taken again
+void stats_reset(void) {
+	irqflags_t flags = cpu_irq_save();
+	uint16_t   boot  = stats.bootReport;
+	memset(&stats, 0, sizeof(stats));
+	stats.bootReport = boot;
+	cpu_irq_restore(flags);
+}
+
+// copies the counters (little endian, packed) into buf, zero padded to len
+void stats_getReport(uint8_t *buf, uint8_t len) {
+	uint8_t n = (sizeof(stats) < len) ? sizeof(stats) : len;
+
+	memset(buf, 0, len);
+	irqflags_t flags = cpu_irq_save();
+	memcpy(buf, &stats, n);
+	cpu_irq_restore(flags);
+}
+
+
+// called by udi_hid_kbd (interrupts off) for every queued report
+void stats_kbdQueued(uint8_t depth) {
+	stats.kbdQueued++;
+	if (depth > stats.kbdQueueMax)
+		stats.kbdQueueMax = depth;
+}
+
+void stats_kbdOverflow(void) {
+	stats.kbdOverflow++;
+}
+
+// the timebase starts with the I/O init right after reset, so its first reading is the boot time
+void stats_firstReport(void) {
+	static bool done;
+	uint32_t    ms;
+
+	if (done)
+		return;
+	done = true;
+	ms   = timebase_now() / 1000;
+	stats.bootReport = (ms > 0xFFFF) ? 0xFFFF : (uint16_t)ms;
+}
@@ -0,0 +1,59 @@
+#ifndef STATS_H
+#define STATS_H
+
+
+typedef struct {
+	/* ------------ low-power wake ------------ */
+	uint16_t wakeCount;       // armed -> scanning transitions
+	uint16_t wakeLatency;     // last touch-to-first-report, scanner ticks
+	uint16_t wakeLatencyMax;  // worst touch-to-first-report, scanner ticks
+	uint32_t armedFrames;     // USB frames (ms) spent armed, scanner stopped
+	uint32_t scanFrames;      // USB frames (ms) spent scanning
+
+	/* ------------- keypad scan -------------- */
+	uint32_t scansSkipped;    // scans ended by the all-columns check (no key down)
+	uint32_t scansFull;       // scans that decoded every column
+	uint16_t scanCycles;      // CPU cycles of the last keypad + slider scan (CONFIG_INPUT_PROFILE)
+	uint16_t scanCyclesMax;   // worst scan, CPU cycles
+	uint16_t ghostBlocked;    // ambiguous (ghosted) chords held back in NKRO mode
+
+	/* ------------ keyboard queue ------------ */
+	uint32_t kbdQueued;       // report snapshots queued
+	uint16_t kbdOverflow;     // snapshots merged because the queue was full
+	uint8_t  kbdQueueMax;     // deepest the queue has been
+
+	/* --------------- joystick --------------- */
+	uint32_t jstkReports;     // joystick reports sent
+	uint16_t jstkRate;        // joystick reports in the last full second
+
+	/* --------------- trackpad --------------- */
+	uint32_t ptrReports;      // pointer reports sent
+	uint16_t ptrCoasts;       // lift-offs that started momentum
+
+	/* ------------- event reports ------------ */
+	uint32_t evtSent;         // timestamped transitions sent
+	uint16_t evtDropped;      // transitions lost because the host was not reading
+
+	/* --------------- gestures --------------- */
+	uint16_t gestures;        // slider gestures recognized
+	uint16_t gesturesDropped; // gestures lost to a full ring
+
+	/* ----------------- boot ----------------- */
+	uint16_t bootReport;      // power-up to the first report taken by the host, ms (kept by stats_reset)
+
+	/* ------------- LED scripts -------------- */
+	uint8_t  scriptOpsMax;    // most script instructions run in one tick
+	uint8_t  scriptFaults;    // scripts stopped on a bad opcode, jump or loop nesting
+} stats_t;
+
+extern stats_t stats;
+
+void stats_reset     (void);
+void stats_getReport (uint8_t *buf, uint8_t len);
+
+void stats_kbdQueued   (uint8_t depth);
+void stats_kbdOverflow (void);
+void stats_firstReport (void);
+
+
+#endif
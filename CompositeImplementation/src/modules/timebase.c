@@ -0,0 +1,56 @@
+/*
+ * timebase.c – Free-running microsecond clock for the EVi Classic firmware
+ *
+ * Purpose: Count microseconds in 32 bits with no interrupt load: TCD0 divides clk_per down to
+ *          1 MHz (12 MHz from conf_clock.h, no TC prescaler gets there), its overflow event on
+ *          channel 1 clocks TCD1 as the lower 16 bits and TCD1's on channel 2 clocks TCF0 as the
+ *          upper 16 bits. clk_per must be a whole number of MHz.
+ *          Wraps after ~71 minutes; callers compare times by unsigned difference.
+ *          Stops with clk_per, i.e. in sleep modes deeper than IDLE.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+
+#include "timebase.h"
+
+
+void timebase_init(void) {
+	sysclk_enable_module(SYSCLK_PORT_D, SYSCLK_TC0);
+	sysclk_enable_module(SYSCLK_PORT_D, SYSCLK_TC1);
+	sysclk_enable_module(SYSCLK_PORT_F, SYSCLK_TC0);
+	sysclk_enable_module(SYSCLK_PORT_GEN, SYSCLK_EVSYS);
+
+	EVSYS.CH1MUX = EVSYS_CHMUX_TCD0_OVF_gc;   // 1 us tick -> event channel 1
+	EVSYS.CH2MUX = EVSYS_CHMUX_TCD1_OVF_gc;   // low half overflow -> event channel 2
+
+	TCF0.CTRLB   = TC_WGMODE_NORMAL_gc;
+	TCF0.PER     = 0xFFFF;
+	TCF0.CNT     = 0;
+	TCF0.CTRLA   = TC_CLKSEL_EVCH2_gc;         // high half counts the overflows
+
+	TCD1.CTRLB   = TC_WGMODE_NORMAL_gc;
+	TCD1.PER     = 0xFFFF;
+	TCD1.CNT     = 0;
+	TCD1.CTRLA   = TC_CLKSEL_EVCH1_gc;         // low half counts microseconds
+
+	TCD0.CTRLB   = TC_WGMODE_NORMAL_gc;
+	TCD0.PER     = (sysclk_get_per_hz() / 1000000UL) - 1;
+	TCD0.CNT     = 0;
+	TCD0.CTRLA   = TC_CLKSEL_DIV1_gc;          // overflows once per us
+}
+
+uint32_t timebase_now(void) {
+	uint16_t hi, lo;
+
+	irqflags_t flags = cpu_irq_save();          // 16 bit reads share the timers' TEMP register
+	do {
+		hi = TCF0.CNT;
+		lo = TCD1.CNT;
+	} while (hi != TCF0.CNT);                   // low half wrapped in between, read again
+	cpu_irq_restore(flags);
+
+	return ((uint32_t)hi << 16) | lo;
+}
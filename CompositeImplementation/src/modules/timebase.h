@@ -0,0 +1,9 @@
+#ifndef TIMEBASE_H
+#define TIMEBASE_H
+
+
+void     timebase_init (void);
+uint32_t timebase_now  (void);
+
+
+#endif
@@ -0,0 +1,153 @@
+/*
+ * trackpad.c – Relative-motion (trackpad) mode for the front-panel sliders
+ *
+ * Purpose: Turn finger travel along the sliders into relative pointer deltas (horizontal = X,
+ *          vertical = wheel or Y) with an acceleration curve on quick strokes, keep coasting after
+ *          a flick with friction decay, and send them on the pointer interface once per frame.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include <stdlib.h>
+#include "conf_trackpad.h"
+
+#include "input.h"
+#include "trackpad.h"
+#include "stats.h"
+
+#define TPAD_X          0
+#define TPAD_V          1   // vertical slider, wheel or Y
+#define TPAD_NO_CONTACT (-1)
+
+#define TPAD_VEL_MAX    ((int32_t)CONFIG_TRACKPAD_VEL_MAX << 8)
+
+typedef struct {
+	int8_t   pos;       // last half-pad position, TPAD_NO_CONTACT when lifted
+	uint16_t lastStep;  // frame of the last position change
+	int16_t  vel;       // coasting speed, counts per frame (8.8)
+	uint8_t  frac;      // fraction of a count carried between coasting frames (0.8)
+	int16_t  pending;   // whole counts not sent yet
+} tpad_axis_t;
+
+static tpad_axis_t tpad_axis[2] = {
+	{ .pos = TPAD_NO_CONTACT },
+	{ .pos = TPAD_NO_CONTACT },
+};
+static uint16_t tpad_frame;                         // frames since power-up (wraps)
+static uint8_t  tpad_mode = CONFIG_SLIDER_MODE;
+static uint8_t  tpad_usbReport[UDI_HID_POINTER_REPORT_IN_SIZE];
+
+
+void trackpad_setMode(uint8_t mode) {
+	if (mode > SLIDER_MODE_TRACKPAD)
+		return;
+	for (uint8_t i = 0; i < 2; i++) {          // a finger down now lands as a fresh touch, no jump
+		tpad_axis[i].pos      = TPAD_NO_CONTACT;
+		tpad_axis[i].lastStep = tpad_frame;
+		tpad_axis[i].vel      = 0;
+		tpad_axis[i].frac     = 0;
+		tpad_axis[i].pending  = 0;
+	}
+	tpad_mode = mode;
+}
+uint8_t trackpad_getMode(void) {
+	return tpad_mode;
+}
+
+
+static uint8_t tpad_gain(uint16_t dt) // acceleration curve, x/8 by ms per half-pad step
+{
+	if (dt <= CONFIG_TRACKPAD_FAST_MS)     return 32;  // x4
+	if (dt <= CONFIG_TRACKPAD_FAST_MS * 2) return 16;  // x2
+	if (dt <= CONFIG_TRACKPAD_FAST_MS * 4) return 12;  // x1.5
+	return 8;
+}
+
+static void tpad_update(tpad_axis_t *a, int8_t pos, uint8_t step)
+{
+	uint16_t dt = tpad_frame - a->lastStep;
+
+	if (pos != TPAD_NO_CONTACT) {
+		if (a->pos == TPAD_NO_CONTACT) {            // touch-down stops any coasting
+			a->vel  = 0;
+			a->frac = 0;
+			a->lastStep = tpad_frame;
+		} else if (pos != a->pos) {
+			int16_t counts = (int16_t)(pos - a->pos) * step * tpad_gain(dt) / 8;
+			int32_t vel    = ((int32_t)counts << 8) / (dt ? dt : 1);
+
+			if (vel >  TPAD_VEL_MAX) vel =  TPAD_VEL_MAX;
+			if (vel < -TPAD_VEL_MAX) vel = -TPAD_VEL_MAX;
+			a->vel      = (int16_t)vel;             // speed of the latest step, kept for lift-off
+			a->pending += counts;
+			a->lastStep = tpad_frame;
+		}
+		a->pos = pos;
+		return;
+	}
+
+	if (a->pos != TPAD_NO_CONTACT) {                // lift-off: coast only out of a moving stroke
+		a->pos = TPAD_NO_CONTACT;
+		if (dt > CONFIG_TRACKPAD_LIFT_MS)
+			a->vel = 0;
+		else if (a->vel)
+			stats.ptrCoasts++;
+	}
+	if (a->vel) {
+		int16_t sum = a->vel + a->frac;
+		a->pending += sum >> 8;                     // floor, keeps the fraction positive
+		a->frac     = (uint8_t)sum;
+		a->vel      = (int16_t)(((int32_t)a->vel * CONFIG_TRACKPAD_FRICTION) >> 8);
+		if (abs(a->vel) < 16)                       // under 1/16 count per ms, stop
+			a->vel = 0;
+	}
+}
+
+static int8_t tpad_take(int16_t *pending) // up to one report's worth of counts
+{
+	int16_t d = *pending;
+
+	if (d >  127) d =  127;
+	if (d < -127) d = -127;
+	*pending -= d;
+	return (int8_t)d;
+}
+
+void trackpad_usbTask(void) // build and send 4 byte report
+{
+	input_snapshot_t const *snap = input_getSnapshot();
+
+	tpad_frame++;
+	tpad_update(&tpad_axis[TPAD_X], snap->horiPos, CONFIG_TRACKPAD_STEP_XY);
+#if CONFIG_TRACKPAD_VERT_WHEEL
+	tpad_update(&tpad_axis[TPAD_V], snap->vertPos, CONFIG_TRACKPAD_STEP_WHEEL);
+#else
+	tpad_update(&tpad_axis[TPAD_V], snap->vertPos, CONFIG_TRACKPAD_STEP_XY);
+#endif
+
+	if (!tpad_axis[TPAD_X].pending && !tpad_axis[TPAD_V].pending)
+		return;
+
+	// pads count up/right (see jstk_ledMask), HID Y grows downward and the wheel grows upward
+	int16_t x = tpad_axis[TPAD_X].pending;
+	int16_t v = tpad_axis[TPAD_V].pending;
+
+	tpad_usbReport[0] = 0;                                      // no buttons
+	tpad_usbReport[1] = (uint8_t)tpad_take(&x);
+#if CONFIG_TRACKPAD_VERT_WHEEL
+	tpad_usbReport[2] = 0;
+	tpad_usbReport[3] = (uint8_t)tpad_take(&v);
+#else
+	tpad_usbReport[2] = (uint8_t)-tpad_take(&v);
+	tpad_usbReport[3] = 0;
+#endif
+
+	if (udi_hid_pointer_send_report_in(tpad_usbReport)) {       // IN endpoint ready?
+		tpad_axis[TPAD_X].pending = x;                          // keep the rest for the next frame
+		tpad_axis[TPAD_V].pending = v;
+		stats.ptrReports++;
+		input_reportSent();
+	}
+}
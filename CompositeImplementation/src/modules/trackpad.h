@@ -0,0 +1,13 @@
+#ifndef TRACKPAD_H
+#define TRACKPAD_H
+
+
+#define SLIDER_MODE_JOYSTICK    0   // absolute axes on the joystick interface
+#define SLIDER_MODE_TRACKPAD    1   // relative deltas on the pointer interface
+
+void    trackpad_setMode (uint8_t mode);
+uint8_t trackpad_getMode (void);
+void    trackpad_usbTask (void);
+
+
+#endif
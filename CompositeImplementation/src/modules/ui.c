@@ -13,13 +13,23 @@
  */
 
 #include <asf.h>
+#include <string.h>
 #include "conf_usb.h"
 
 #include "ui.h"
 #include "io.h"
 #include "led.h"
+#include "fade.h"
+#include "script.h"
 #include "keypad.h"
 #include "joystick.h"
+#include "trackpad.h"
+#include "digitizer.h"
+#include "gesture.h"
+#include "filter.h"
+#include "events.h"
+#include "input.h"
+#include "stats.h"
 
 #define IDLE (1 << 1)
 
@@ -28,12 +38,21 @@
 #define STATUS_ON  0x48
 #define STATUS_OFF 0x51
 
-static volatile uint16_t sof_ms       = 0;
+#define FEATURE_STATS   0x01   // feature report page: runtime statistics
+#define FEATURE_KEYPAD  0x02   // feature report page: keypad report mode & multipress policy
+#define FEATURE_KEYMAP  0x03   // feature report page: keymap, one HID code per matrix position
+#define FEATURE_SLIDER  0x04   // feature report page: slider mode, joystick or trackpad
+#define FEATURE_GESTURE 0x05   // feature report page: keyboard usage per slider gesture
+#define FEATURE_FILTER  0x06   // feature report page: joystick axis filter & jitter replay
+#define FEATURE_LEVEL   0x07   // feature report page: LED brightness, LED1-8 then status
+#define FEATURE_SCRIPT  0x08   // feature report page: LED animation scripts
+
+static uint8_t feature_page = FEATURE_STATS;
+
 static volatile bool     startupCheck = 1;
 static bool              userActive   = 0;
 
 static volatile uint8_t jstk_exitTestMode;
-static volatile uint8_t jstk_testMode;
 
 /* --------------------------------------- */
 /* ------------------ IO ----------------- */
@@ -47,30 +66,59 @@ void io_ui_process(void) {
 /* ----------------- GUI ----------------- */
 /* --------------------------------------- */
 void gui_ui_process(void) {
+	input_snapshot_t const *snap = input_getSnapshot();
 	uint16_t ledBits   = led_getMap ();
-	uint16_t keyBits   = kbd_getMap ();
-	uint32_t joyBits   = jstk_getMap();
+	uint16_t keyBits   = kbd_getMap (snap->keys);
+	uint32_t joyBits   = snap->pads;
 	
 	uint8_t  report[7] = {
 		(uint8_t)( ledBits        & 0xFF),
 		(uint8_t)((ledBits >> 8)  & 0xFF) |
-		          (idleStatus()   ? IDLE:0),
+		          (script_running() ? IDLE:0),
 		(uint8_t)( keyBits        & 0xFF),
 		(uint8_t)((keyBits >> 8)  & 0xFF),
 		(uint8_t)( joyBits        & 0xFF),
 		(uint8_t)((joyBits >> 8)  & 0xFF),
 		(uint8_t)((joyBits >> 16) & 0xFF),
 	};
-	udi_hid_led_send_report_in(report);
+	if (udi_hid_led_send_report_in(report))
+		stats_firstReport();
 } // 7 byte output for GUI
 
 
+/* ---------------------------------------- */
+/* ---------------- input ----------------- */
+/* ---------------------------------------- */
+void input_ui_process(void) {
+	input_event_t ev;
+
+	while (input_pop(&ev)) {
+		if (ev.src == INPUT_SRC_KEYPAD) {
+			keypad_event(ev.bit, ev.pressed);
+			if (keypad_getReportMode() != KEYPAD_REPORT_NKRO)
+				keypad_report(); // step per edge so a short tap isn't merged away
+			                     // (NKRO sends the whole set once, from kbd_ui_process)
+		} else {
+			jstk_event(ev.bit, ev.pressed);
+		}
+		events_push(&ev);    // timestamped copy for the event interface
+	}
+
+	if (input_lost()) { // ring overflowed (e.g. USB not ready), resync from the scanner
+		keypad_sync();
+		jstk_sync();
+	}
+
+	input_snapshot(); // what every report below sees this frame
+} // drains scanner events
+
+
 /* ---------------------------------------- */
 /* --------------- keyboard --------------- */
 /* ---------------------------------------- */
 void kbd_ui_process(void) {
-	keypad_poll();
 	keypad_report();
+	gesture_report();
 } // keyboard logic
 
 
@@ -79,9 +127,9 @@ void kbd_ui_process(void) {
 /* ---------------------------------------- */
 void jstk_ui_process(void) {
 	uint8_t jstk_mask = jstk_readMask();
-	uint8_t jstk_testMode = PORTB.IN;
+	bool    jstk_testMode = input_getSnapshot()->testMode;
 
-	if ((jstk_testMode & PIN4_bm) == 0) {
+	if (jstk_testMode) {
 		if (jstk_mask) {
 			led_allOff();
 			led_on(jstk_mask);
@@ -89,16 +137,43 @@ void jstk_ui_process(void) {
 			jstk_exitTestMode = 1;
 		}
 	} else {
-		jstk_usbTask();
+		if (trackpad_getMode() == SLIDER_MODE_JOYSTICK)
+			jstk_usbTask();
 
-		if (((jstk_testMode & 0x010) != 0) && 
-			 (jstk_exitTestMode      == 1)) {
+		if (jstk_exitTestMode == 1) {
 			led_quiet_allOff();
 			jstk_exitTestMode = 0;
 		}
 	}
 } // joystick logic
 
+void ptr_ui_process(void) {
+	if (!input_getSnapshot()->testMode &&
+		 (trackpad_getMode() == SLIDER_MODE_TRACKPAD))
+		trackpad_usbTask();
+} // trackpad logic
+
+void digi_ui_process(void) {
+	if (!input_getSnapshot()->testMode)
+		digitizer_usbTask();
+} // touch surface logic
+
+
+/* ---------------------------------------- */
+/* ---------------- events ---------------- */
+/* ---------------------------------------- */
+void evt_ui_enable(bool on) {
+	events_enable(on);
+}
+
+void evt_ui_sof(void) {
+	events_sof();
+}
+
+void evt_ui_process(void) {
+	events_usbTask();
+} // sends timestamped transitions
+
 
 /* ---------------------------------------- */
 /* ----------------- LEDs ----------------- */
@@ -112,7 +187,7 @@ void led_ui_report(uint8_t const *code) {
 		led_setState(ledMask);
 	} else if (command == START)      {
 		activityReset();
-		idleStart();
+		script_runIdle();
 	} else if (command == STATUS_ON)  {
 		led_statusOn();
 		led_setState(ledMask);
@@ -125,48 +200,149 @@ void led_ui_report(uint8_t const *code) {
 } // allows host PC to manually control LEDs
 
 
+/* ---------------------------------------- */
+/* ------------ feature report ------------ */
+/* ---------------------------------------- */
+// SET: byte 0 selects the page returned by the next GET, the rest is page specific
+//   FEATURE_STATS  – byte 1 = 1 clears the counters (not bootReport, measured once per power-up)
+//   FEATURE_KEYPAD – byte 1 = report mode, byte 2 = multipress policy
+//   FEATURE_KEYMAP – byte 1 = 1 store bytes 2.. as the keymap (ignored if a code is past the
+//                    keyboard report's usages), 2 restore the defaults
+//   FEATURE_SLIDER – byte 1 = slider mode
+//   FEATURE_GESTURE – byte 1 = 1 store bytes 2.. as the gesture usages (see gesture.h for the order)
+//   FEATURE_FILTER – byte 1 = filter, 2 = hysteresis, 3 = deadzone, 4 = seconds of jitter replay
+//   FEATURE_LEVEL  – byte 1 = 1 sets bytes 2-10 as the brightness of LED1-8 and status (0-255)
+//   FEATURE_SCRIPT – byte 1 = 1 run script id byte 2, 2 stop, 3 upload the code in bytes 3..
+//                    (byte 2 = length), 4 save it to EEPROM (byte 2 = 1 as the idle animation)
+void feature_ui_set(uint8_t const *report) {
+	feature_page = report[0];
+
+	switch (feature_page) {
+	case FEATURE_STATS:
+		if (report[1] == 1)
+			stats_reset();
+		break;
+	case FEATURE_KEYPAD:
+		keypad_setReportMode (report[1]);
+		keypad_setMultiPolicy(report[2]);
+		break;
+	case FEATURE_KEYMAP:
+		if (report[1] == 1)
+			keypad_setKeymap(&report[2]);
+		else if (report[1] == 2)
+			keypad_setKeymap(NULL);
+		break;
+	case FEATURE_SLIDER:
+		trackpad_setMode(report[1]);
+		break;
+	case FEATURE_GESTURE:
+		if (report[1] == 1)
+			gesture_setMap(&report[2]);
+		break;
+	case FEATURE_FILTER:
+		filter_setConfig(report[1], report[2], report[3]);
+		if (report[4])
+			jstk_replay(report[4]);
+		break;
+	case FEATURE_LEVEL:
+		if (report[1] == 1)
+			for (uint8_t i = 0; i < 9; i++)
+				led_setLevel(1u << i, report[2 + i]);
+		break;
+	case FEATURE_SCRIPT:
+		if      (report[1] == 1) script_run(report[2]);
+		else if (report[1] == 2) script_stop();
+		else if (report[1] == 3) script_load(&report[3], report[2]);
+		else if (report[1] == 4) script_save(report[2]);
+		break;
+	default:
+		break;
+	}
+}
+
+// GET: byte 0 echoes the page, the page data follows
+void feature_ui_get(uint8_t *report) {
+	memset(report, 0, UDI_HID_LED_REPORT_FEATURE_SIZE);
+	report[0] = feature_page;
+
+	switch (feature_page) {
+	case FEATURE_STATS:
+		stats_getReport(&report[1], UDI_HID_LED_REPORT_FEATURE_SIZE - 1);
+		break;
+	case FEATURE_KEYPAD:
+		report[1] = keypad_getReportMode ();
+		report[2] = keypad_getMultiPolicy();
+		break;
+	case FEATURE_KEYMAP:                          // byte 1 = 1 if the EEPROM override is active
+		report[1] = keypad_getKeymap(&report[2]);
+		break;
+	case FEATURE_SLIDER:
+		report[1] = trackpad_getMode();
+		break;
+	case FEATURE_GESTURE: {                       // bytes 1.. usages, then the last gesture seen
+		gesture_t last;
+		gesture_getMap(&report[1]);
+		gesture_getLast(&last);
+		report[1 + GESTURE_MAP_SIZE] = last.slider;
+		report[2 + GESTURE_MAP_SIZE] = last.type;
+		report[3 + GESTURE_MAP_SIZE] = last.speed;
+		break;
+	}
+	case FEATURE_FILTER:                          // byte 4 = replay seconds left, rate is on the stats page
+		filter_getConfig(&report[1]);
+		report[4] = jstk_replayLeft();
+		break;
+	case FEATURE_LEVEL:
+		for (uint8_t i = 0; i < 9; i++)
+			report[1 + i] = led_getLevel(i);
+		break;
+	case FEATURE_SCRIPT:
+		script_getStatus(&report[1]);
+		break;
+	default:
+		break;
+	}
+}
+
+
 /* ---------------------------------------- */
 /* -------------- status LED -------------- */
 /* ---------------------------------------- */
 void status_ui_process(uint8_t usbMode) {
 	static bool prev = false;
-	bool curr = ((PORTB.IN & PIN4_bm) == 0);
-	sof_ms++;
-
-	if (curr) { // if currently in test mode
-		// SoF driven timer
-		if (usbMode == 1) {
-			if (sof_ms >= 500) {
-				led_statusToggle();
-				sof_ms = 0;
-			}
-		// while-loop driven timer
-		} else if (usbMode == 0) {
-			if (sof_ms >= 500) {
-				led_statusToggle();
-				sof_ms = 0;
-			}
-		} // adjust timing as needed
-	} else { // if not currently in test mode
-		if (prev) // if just exiting test mode
-			led_statusOff();
-		sof_ms = 0;
-	}
+	bool curr = input_getSnapshot()->testMode;
+	UNUSED(usbMode); // SoF or while-loop, the fade runs off fade_ui_process either way
+
+	if (curr && !prev)      // just entering test mode
+		led_statusBreathe(1000);
+	else if (!curr && prev) // just exiting test mode
+		led_statusOff();
 	prev = curr;
-} // blink status LED in test mode
+} // breathe status LED in test mode
 
 
 /* ---------------------------------------- */
 /* ------------ startup & idle ------------ */
 /* ---------------------------------------- */
+void startup_ui_start(void) {
+	startupStart();
+	startupCheck = 1;
+} // lights the startup LED sequence
+
 void startup_ui_process(void) {
-	startupCheck = startupSequence();
-} // performs startup LED sequence
+	if (startupCheck)
+		startupCheck = startupPoll();
+} // steps the startup LED sequence (1 ms)
+
 
+void fade_ui_process(void) {
+	fade_tick();
+} // advances LED fades (1 ms)
 
 void idle_ui_process(void) {
-	idlePoll();
-} // performs idle LED sequence
+	if (!startupCheck)     // the idle script waits for the startup sequence
+		script_tick();
+} // runs LED animation scripts (1 ms)
 
 
 /* ---------------------------------------- */
@@ -8,21 +8,41 @@ void io_ui_process(void);
 /* ---------------- GUI --------------- */
 void gui_ui_process(void);
 
+/* -------------- input --------------- */
+void input_ui_process(void);
+
 /* ------------- keyboard ------------- */
 void kbd_ui_process(void);
 
 /* ------------- joystick ------------- */
 void jstk_ui_process(void);
 
+/* ------------- trackpad ------------- */
+void ptr_ui_process(void);
+
+/* ------------- digitizer ------------ */
+void digi_ui_process(void);
+
+/* -------------- events -------------- */
+void evt_ui_enable (bool on);
+void evt_ui_sof    (void);
+void evt_ui_process(void);
+
 /* --------------- LEDs --------------- */
 void led_ui_report(uint8_t const *mask);
 
+/* ---------- feature report ---------- */
+void feature_ui_set(uint8_t const *report);
+void feature_ui_get(uint8_t *report);
+
 /* ------------ status LED ------------ */
 // void status_ui_process(void);
 void status_ui_process(uint8_t usbMode);
 
 /* ---------- startup & idle ---------- */
+void startup_ui_start  (void);
 void startup_ui_process(void);
+void fade_ui_process   (void);
 void idle_ui_process   (void);
 
 /* ------ LED activity detection ------ */
@@ -0,0 +1,131 @@
+/*
+ * debounce_replay.c – Spurious transitions through the vertical-counter debouncer
+ *
+ * Purpose: Replay bouncing switch traces through debounce_update() and count, per trace, the
+ *          edges of the clean contact, of the raw samples and of the debounced state. A debounced
+ *          edge that does not follow a clean edge is spurious, a clean edge that never shows up
+ *          is missed, and the lag is measured from the clean edge. Traces whose bounce stays
+ *          inside CONFIG_DEBOUNCE_MS must come through with no spurious or missed edge; the
+ *          longer-bounce trace only shows what leaks.
+ *
+ *          debounce_replay [trace ...]   recorded raw traces, one hex word per line
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include "conf_input.h"
+#include "debounce.h"
+
+#include "host.h"
+
+typedef struct {
+	uint32_t clean;        // clean contact edges
+	uint32_t raw;          // raw sample edges
+	uint32_t passed;       // debounced edges
+	uint32_t spurious;     // debounced edges without a clean edge
+	uint32_t missed;       // clean edges without a debounced edge
+	uint32_t lagMax;       // ticks from the clean edge to the debounced edge
+	uint64_t lagSum;
+} replay_t;
+
+static const uint8_t replay_keys[] = { 0, 1, 4, 5, 8, 14, 15, 18, 19 };
+
+static void replay(const trace_t *t, replay_t *r) {
+	debounce_t db;
+	uint32_t   pending = 0;                  // clean edges not matched yet
+	uint32_t   edgeTick[32];
+
+	memset(r, 0, sizeof(*r));
+	debounce_init(&db);
+
+	for (uint32_t i = 0; i < t->n; ++i) {
+		uint32_t cleanEdge = i ? (t->clean[i] ^ t->clean[i - 1]) : t->clean[0];
+		uint32_t rawEdge   = i ? (t->raw[i]   ^ t->raw[i - 1])   : t->raw[0];
+
+		r->clean += __builtin_popcount(cleanEdge);
+		r->raw   += __builtin_popcount(rawEdge);
+		r->missed += __builtin_popcount(pending & cleanEdge);   // the previous edge never came through
+		pending |= cleanEdge;
+		for (uint32_t e = cleanEdge; e; e &= e - 1)
+			edgeTick[ctz(e)] = i;
+
+		uint32_t changed = debounce_update(&db, t->raw[i]);
+		r->passed += __builtin_popcount(changed);
+		for (uint32_t e = changed; e; e &= e - 1) {
+			uint8_t  bit  = ctz(e);
+			uint32_t mask = (uint32_t)1 << bit;
+			if ((pending & mask) && !((db.state ^ t->clean[i]) & mask)) {
+				uint32_t lag = i - edgeTick[bit];
+				pending &= ~mask;
+				r->lagSum += lag;
+				if (lag > r->lagMax)
+					r->lagMax = lag;
+			} else {
+				r->spurious++;
+			}
+		}
+	}
+}
+
+static void replay_print(const char *name, const replay_t *r) {
+	uint32_t matched = r->passed - r->spurious;
+
+	printf("%-14s %7u %7u %7u %7u %8u %7u %6.1f %5u\n", name, r->clean, r->raw,
+	       r->raw - r->clean, r->passed, r->spurious, r->missed,
+	       matched ? (double)r->lagSum / matched : 0.0, r->lagMax);
+}
+
+// generated trace: every edge must come through once, within the bounce, a spike and the debounce lag
+static void replay_check(const char *name, trace_t *t, uint32_t bounceMax) {
+	replay_t r;
+
+	trace_bounce(t, bounceMax, 5);
+	replay(t, &r);
+	replay_print(name, &r);
+	CHECK(r.spurious == 0, "%s: %u spurious edges", name, r.spurious);
+	CHECK(r.missed == 0, "%s: %u missed edges", name, r.missed);
+	CHECK(r.lagMax <= bounceMax + TRACE_GLITCH_MAX + DEBOUNCE_LAG_TICKS + DEBOUNCE_SAMPLE_TICKS,
+	      "%s: lag %u ticks", name, r.lagMax);
+}
+
+int main(int argc, char **argv) {
+	trace_t  t;
+	replay_t r;
+	uint32_t inSpec = CONFIG_DEBOUNCE_MS * CONFIG_INPUT_SCAN_HZ / 1000 - 1;  // bounce ticks the window covers
+
+	printf("window %u ms, sample every %u tick(s)\n", CONFIG_DEBOUNCE_MS, (unsigned)DEBOUNCE_SAMPLE_TICKS);
+	printf("%-14s %7s %7s %7s %7s %8s %7s %6s %5s\n", "trace", "clean", "raw", "bounce",
+	       "passed", "spurious", "missed", "lag", "max");
+
+	if (argc > 1) {                              // no clean reference: passed vs raw edges only
+		for (int a = 1; a < argc; ++a) {
+			CHECK(trace_load(&t, argv[a]), "cannot read %s", argv[a]);
+			replay(&t, &r);
+			printf("%-14s %7s %7u %7s %7u\n", argv[a], "-", r.raw, "-", r.passed);
+			trace_free(&t);
+		}
+		return 0;
+	}
+
+	trace_alloc(&t, 120000);                     // keypad, 2 minutes
+	trace_typing(&t, replay_keys, sizeof(replay_keys), 30);
+	replay_check("keypad", &t, inSpec);
+	trace_free(&t);
+
+	trace_alloc(&t, 120000);                     // both sliders, slow to quick strokes
+	trace_swipes(&t, 0, 10, 60);
+	trace_swipes(&t, 12, 10, 60);
+	replay_check("sliders", &t, inSpec);
+	trace_free(&t);
+
+	trace_alloc(&t, 120000);                     // contacts bouncing three times the window
+	trace_typing(&t, replay_keys, sizeof(replay_keys), 30);
+	trace_bounce(&t, 3 * CONFIG_DEBOUNCE_MS, 5);
+	replay(&t, &r);
+	replay_print("keypad, worn", &r);
+	trace_free(&t);
+
+	return 0;
+}
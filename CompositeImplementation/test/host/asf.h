@@ -0,0 +1,103 @@
+/*
+ * asf.h – Host stand-in for the ASF/XMEGA headers
+ *
+ * Purpose: Let the firmware modules under test compile unchanged with the host gcc. Registers are
+ *          plain structs, the scanned ports go through host_port() so reads see the simulated
+ *          keypad matrix and slider pads (host.c), everything else is a no-op.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#ifndef HOST_ASF_H
+#define HOST_ASF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+
+/* ------------------------------ compiler ------------------------------ */
+#define COMPILER_PACK_SET(n)
+#define COMPILER_PACK_RESET()
+typedef uint16_t le16_t;
+
+// sized like ASF's clz_ctz.h, which picks the 8/16/32 bit version from sizeof(x)
+#define host_bits(x)               (sizeof(x) == 1 ? 8 : (sizeof(x) == 2 ? 16 : 32))
+#define clz(x)  ((uint8_t)((x) ? __builtin_clz((uint32_t)(x)) - (32 - host_bits(x)) : host_bits(x)))
+#define ctz(x)  ((uint8_t)((x) ? __builtin_ctz((uint32_t)(x)) : host_bits(x)))
+
+typedef uint8_t irqflags_t;
+static inline irqflags_t cpu_irq_save(void)         { return 0; }
+static inline void cpu_irq_restore(irqflags_t flags) { (void)flags; }
+
+#define PROGMEM_DECLARE(type, name) const type name
+#define PROGMEM_READ_BYTE(x)        (*(const uint8_t *)(x))
+
+
+/* ------------------------------ registers ----------------------------- */
+typedef volatile uint8_t reg8_t;
+
+typedef struct {
+	reg8_t DIR, DIRSET, DIRCLR, DIRTGL, OUT, OUTSET, OUTCLR, OUTTGL, IN;
+	reg8_t INTCTRL, INT0MASK, INT1MASK, INTFLAGS;
+} PORT_t;
+
+typedef struct {
+	reg8_t DIR, OUT, IN, INTFLAGS;
+} VPORT_t;
+
+#define HOST_PORT_B   0
+#define HOST_PORT_C   1
+#define HOST_PORT_D   2
+#define HOST_PORT_E   3
+#define HOST_PORT_F   4
+#define HOST_PORTS    5
+
+PORT_t  *host_port  (uint8_t port);   // applies pending writes, then updates IN
+VPORT_t *host_vport (uint8_t port);
+
+#define PORTB    (*host_port(HOST_PORT_B))
+#define PORTC    (*host_port(HOST_PORT_C))
+#define PORTD    (*host_port(HOST_PORT_D))
+#define PORTE    (*host_port(HOST_PORT_E))
+#define PORTF    (*host_port(HOST_PORT_F))
+#define VPORT0   (*host_vport(HOST_PORT_F))   // same mapping as io_init()
+#define VPORT1   (*host_vport(HOST_PORT_B))
+#define VPORT2   (*host_vport(HOST_PORT_C))
+#define VPORT3   (*host_vport(HOST_PORT_D))
+
+#define PIN0_bm  0x01
+#define PIN1_bm  0x02
+#define PIN2_bm  0x04
+#define PIN3_bm  0x08
+#define PIN4_bm  0x10
+#define PIN5_bm  0x20
+#define PIN6_bm  0x40
+#define PIN7_bm  0x80
+
+#define PORT_INT0IF_bm        0x01
+#define PORT_INT0LVL_OFF_gc   0x00
+#define PORT_INT0LVL_LO_gc    0x01
+
+
+/* ------------------------------- drivers ------------------------------ */
+void nvm_eeprom_read_buffer            (uint16_t addr, void *buf, uint16_t len);
+void nvm_eeprom_erase_and_write_buffer (uint16_t addr, const void *buf, uint16_t len);
+
+#include "usb_protocol_hid.h"
+
+// report layout as configured in conf_usb.h and udi_hid_kbd.h
+#define UDI_HID_JSTK_HIRES            1
+#define UDI_HID_JSTK_REPORT_IN_SIZE   7
+#define UDI_HID_KBD_NKRO_USAGE_MAX    103
+
+bool     udi_hid_kbd_up   (uint8_t key_id);
+bool     udi_hid_kbd_down (uint8_t key_id);
+bool     udi_hid_kbd_set  (uint8_t const *key_ids, uint8_t nb_key);
+bool     udi_hid_joystick_send_report_in (uint8_t *data);
+uint16_t udd_get_frame_number (void);
+
+
+#endif
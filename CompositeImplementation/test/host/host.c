@@ -0,0 +1,323 @@
+/*
+ * host.c – Simulated board for the host-side tests
+ *
+ * Purpose: Model the keypad matrix and the slider pads behind the stubbed ports, stand in for the
+ *          modules a test does not link (USB, LEDs, EEPROM, input snapshot), and build the input
+ *          traces the tests replay.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "keypad.h"
+#include "sampler.h"
+#include "stats.h"
+
+#include "host.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#  include <x86intrin.h>
+#else
+#  include <time.h>
+#endif
+
+stats_t          stats;
+input_snapshot_t host_snapshot;
+char             host_kbdLog[256];
+uint32_t         host_ioCount;
+
+static PORT_t   host_ports[HOST_PORTS];
+static VPORT_t  host_vports[HOST_PORTS];
+static uint8_t  host_vportOut[HOST_PORTS];   // VPORT OUT as of the last sync
+static uint32_t host_keys;
+static uint32_t host_pads;
+
+
+/* ---------------------------------------------------------------------- */
+/* ------------------------------ port model ---------------------------- */
+/* ---------------------------------------------------------------------- */
+// row bits (PF4-PF7, 1 = pulled low) seen with the current column drive
+static uint8_t host_rows(void) {
+	uint8_t rows = 0;
+
+	for (uint8_t col = 0; col < KEYPAD_COLS; ++col) {
+		bool driven = (col < 4) ? !(host_ports[HOST_PORT_F].OUT & (1u << col))
+		                        : !(host_ports[HOST_PORT_B].OUT & PIN7_bm);
+		if (driven)
+			rows |= (host_keys >> (col * KEYPAD_ROWS)) & 0x0F;
+	}
+	return rows;
+}
+
+// runs before every register access, so a write is in effect for the next read
+static void host_sync(void) {
+	for (uint8_t p = 0; p < HOST_PORTS; ++p) {
+		PORT_t  *port  = &host_ports[p];
+		VPORT_t *vport = &host_vports[p];
+
+		port->OUT   |= port->OUTSET;
+		port->OUT   &= ~port->OUTCLR;
+		port->OUT   ^= port->OUTTGL;
+		port->OUTSET = port->OUTCLR = port->OUTTGL = 0;
+
+		if (vport->OUT != host_vportOut[p])        // written through the virtual port
+			port->OUT = vport->OUT;
+		vport->OUT = host_vportOut[p] = port->OUT;
+	}
+
+	uint16_t vert = host_pads & 0x0FFF;            // pads pull their pin low
+	uint16_t hori = (host_pads >> 12) & 0x0FFF;
+
+	host_ports[HOST_PORT_F].IN = (uint8_t)(~(host_rows() << 4) & 0xF0) | (host_ports[HOST_PORT_F].OUT & 0x0F);
+	host_ports[HOST_PORT_C].IN = (uint8_t)~(vert << 2) | 0x03;
+	host_ports[HOST_PORT_D].IN = (uint8_t)~(vert >> 6) | 0xC0;
+	host_ports[HOST_PORT_E].IN = (uint8_t)~hori;
+	host_ports[HOST_PORT_B].IN = (uint8_t)(~(hori >> 8) & 0x0F) | 0xF0;   // PB4 high: test switch open
+	for (uint8_t p = 0; p < HOST_PORTS; ++p)
+		host_vports[p].IN = host_ports[p].IN;
+}
+
+PORT_t *host_port(uint8_t port) {
+	host_ioCount++;
+	host_sync();
+	return &host_ports[port];
+}
+
+VPORT_t *host_vport(uint8_t port) {
+	host_ioCount++;
+	host_sync();
+	return &host_vports[port];
+}
+
+void host_setKeys(uint32_t keys) {
+	host_keys = keys;
+}
+
+void host_setPads(uint32_t pads) {
+	host_pads = pads;
+}
+
+
+/* ---------------------------------------------------------------------- */
+/* -------------------------- modules not linked ------------------------ */
+/* ---------------------------------------------------------------------- */
+void nvm_eeprom_read_buffer(uint16_t addr, void *buf, uint16_t len) {
+	(void)addr;
+	memset(buf, 0xFF, len);                        // erased
+}
+
+void nvm_eeprom_erase_and_write_buffer(uint16_t addr, const void *buf, uint16_t len) {
+	(void)addr; (void)buf; (void)len;
+}
+
+static void host_kbd(char op, uint8_t arg) {
+	size_t n = strlen(host_kbdLog);
+	if (n + 5 < sizeof(host_kbdLog))
+		snprintf(host_kbdLog + n, sizeof(host_kbdLog) - n, "%c%02X ", op, arg);
+}
+
+bool udi_hid_kbd_up(uint8_t key_id)   { host_kbd('-', key_id); return true; }
+bool udi_hid_kbd_down(uint8_t key_id) { host_kbd('+', key_id); return true; }
+bool udi_hid_kbd_set(uint8_t const *key_ids, uint8_t nb_key) {
+	(void)key_ids;
+	host_kbd('=', nb_key);
+	return true;
+}
+
+void led_toggle(uint8_t mask)  { (void)mask; }
+void led_quiet_allOff(void)    { }
+
+uint8_t sampler_vote(uint8_t port) {                // every DMA sample equal to the port
+	switch (port) {
+	case SAMPLER_PORT_C: return PORTC.IN;
+	case SAMPLER_PORT_D: return PORTD.IN;
+	case SAMPLER_PORT_E: return PORTE.IN;
+	default:             return PORTB.IN;
+	}
+}
+
+bool udi_hid_joystick_send_report_in(uint8_t *data) {
+	(void)data;
+	return true;
+}
+uint16_t udd_get_frame_number(void) {
+	return 0;
+}
+
+input_snapshot_t const *input_getSnapshot(void) {
+	return &host_snapshot;
+}
+void input_reportSent(void) { }
+
+
+/* ---------------------------------------------------------------------- */
+/* -------------------------------- timing ------------------------------ */
+/* ---------------------------------------------------------------------- */
+uint64_t host_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+#endif
+}
+
+
+/* ---------------------------------------------------------------------- */
+/* -------------------------------- traces ------------------------------ */
+/* ---------------------------------------------------------------------- */
+static uint32_t host_seed = 0x2545F491;
+
+uint32_t host_rand(void) {                         // xorshift32, same sequence every run
+	host_seed ^= host_seed << 13;
+	host_seed ^= host_seed >> 17;
+	host_seed ^= host_seed << 5;
+	return host_seed;
+}
+
+uint32_t host_range(uint32_t lo, uint32_t hi) {
+	return lo + host_rand() % (hi - lo + 1);
+}
+
+void trace_alloc(trace_t *t, uint32_t n) {
+	t->raw   = calloc(n, sizeof(uint32_t));
+	t->clean = calloc(n, sizeof(uint32_t));
+	t->n     = n;
+	if (!t->raw || !t->clean) {
+		printf("out of memory\n");
+		exit(2);
+	}
+}
+
+void trace_free(trace_t *t) {
+	free(t->raw);
+	free(t->clean);
+	t->raw = t->clean = NULL;
+	t->n   = 0;
+}
+
+// a recorded trace has no clean reference, raw and clean both hold the samples
+bool trace_load(trace_t *t, const char *path) {
+	FILE     *f = fopen(path, "r");
+	char      line[64];
+	uint32_t  cap = 4096;
+
+	if (!f)
+		return false;
+	trace_alloc(t, cap);
+	t->n = 0;
+	while (fgets(line, sizeof(line), f)) {
+		char *end;
+		unsigned long v = strtoul(line, &end, 16);
+		if (end == line || line[0] == '#')
+			continue;
+		if (t->n == cap) {
+			cap *= 2;
+			t->raw   = realloc(t->raw,   cap * sizeof(uint32_t));
+			t->clean = realloc(t->clean, cap * sizeof(uint32_t));
+			if (!t->raw || !t->clean) {
+				printf("out of memory\n");
+				exit(2);
+			}
+		}
+		t->raw[t->n] = t->clean[t->n] = (uint32_t)v;
+		t->n++;
+	}
+	fclose(f);
+	return true;
+}
+
+/*
+ * contact bounce: after every clean edge the switch chatters for 0..bounceMax ticks before it
+ * settles, and glitchPer10k ticks in 10000 carry a short spike on a switch that is at rest
+ */
+void trace_bounce(trace_t *t, uint32_t bounceMax, uint32_t glitchPer10k) {
+	uint32_t used = 0;
+
+	for (uint32_t i = 0; i < t->n; ++i)
+		used |= t->clean[i];
+	memcpy(t->raw, t->clean, t->n * sizeof(uint32_t));
+
+	for (uint32_t i = 1; i < t->n; ++i) {
+		for (uint32_t e = t->clean[i] ^ t->clean[i - 1]; e; e &= e - 1) {
+			uint32_t bit = e & -e;
+			uint32_t len = host_range(0, bounceMax);
+			for (uint32_t k = 0; k < len && i + k < t->n; ++k)
+				t->raw[i + k] ^= (host_rand() & 1) ? bit : 0;
+		}
+		if (used && host_range(0, 9999) < glitchPer10k) {
+			uint32_t bit = 0;
+			while (!(used & bit))
+				bit = (uint32_t)1 << host_range(0, 31);
+			for (uint32_t k = host_range(1, TRACE_GLITCH_MAX); k && i + k < t->n; --k)
+				if (!((t->clean[i + k] ^ t->clean[i + k - 1]) & bit))
+					t->raw[i + k] ^= bit;
+		}
+	}
+}
+
+/*
+ * typing on the listed keys: one key at a time with 80-400 ms between strokes, held 40-200 ms;
+ * chordPct of the strokes press a second key while the first is held
+ */
+void trace_typing(trace_t *t, const uint8_t *bits, uint8_t nbits, uint8_t chordPct) {
+	uint32_t i = host_range(20, 200);
+
+	while (i < t->n) {
+		uint8_t  a    = bits[host_range(0, nbits - 1)];
+		uint32_t hold = host_range(40, 200);
+		uint32_t end  = i + hold;
+
+		for (uint32_t k = i; k < end && k < t->n; ++k)
+			t->clean[k] |= (uint32_t)1 << a;
+
+		if (nbits > 1 && host_range(0, 99) < chordPct) {
+			uint8_t b = a;
+			while (b == a)
+				b = bits[host_range(0, nbits - 1)];
+			uint32_t start = i + host_range(10, hold - 10);
+			uint32_t stop  = start + host_range(40, 200);
+			for (uint32_t k = start; k < stop && k < t->n; ++k)
+				t->clean[k] |= (uint32_t)1 << b;
+			if (stop > end)
+				end = stop;
+		}
+		i = end + host_range(80, 400);
+	}
+}
+
+/*
+ * slider strokes: touch down on a pad, rest 30-150 ms, slide to another pad at lo..hi pads per
+ * second, rest again and lift, 100-500 ms between strokes. the finger covers the pad under it
+ * and, over the last 40% of a pad, the next one too.
+ */
+void trace_swipes(trace_t *t, uint8_t shift, uint16_t lo, uint16_t hi) {
+	uint32_t i = host_range(20, 200);
+
+	while (i < t->n) {
+		int32_t  pos   = host_range(0, 11) * 1000;      // thousandths of a pad
+		int32_t  to    = host_range(0, 11) * 1000;
+		int32_t  speed = host_range(lo, hi);            // thousandths per tick = pads per second
+		uint32_t rest  = host_range(30, 150);
+		uint32_t end   = i + rest + (uint32_t)(abs(to - pos) / speed) + host_range(30, 150);
+
+		for (uint32_t k = i; k < end && k < t->n; ++k) {
+			if (k >= i + rest && pos != to) {
+				if (abs(to - pos) <= speed)
+					pos = to;
+				else
+					pos += (to > pos) ? speed : -speed;
+			}
+			uint8_t  pad  = pos / 1000;
+			uint32_t pads = 1u << pad;
+			if (pos % 1000 > 600 && pad < 11)
+				pads |= 2u << pad;
+			t->clean[k] |= pads << shift;
+		}
+		i = end + host_range(100, 500);
+	}
+}
@@ -0,0 +1,57 @@
+#ifndef HOST_H
+#define HOST_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "input.h"
+
+
+/* -------------------------- simulated inputs -------------------------- */
+void     host_setKeys (uint32_t keys);   // keypad matrix, bit (col * KEYPAD_ROWS + row), 1 = down
+void     host_setPads (uint32_t pads);   // slider pads, vertical 0-11, horizontal 12-23, 1 = touched
+
+extern input_snapshot_t host_snapshot;   // returned by input_getSnapshot()
+extern char             host_kbdLog[];   // keyboard calls: "+28 " down, "-28 " up, "=2 " set of 2
+extern uint32_t         host_ioCount;    // register accesses through host_port() / host_vport()
+
+
+/* ------------------------------- timing ------------------------------- */
+uint64_t host_cycles (void);             // TSC on x86, ns elsewhere
+
+
+/* ------------------------------- traces ------------------------------- */
+// one raw sample per scanner tick (1 ms); clean is the contact state without bounce.
+// the generators add their contacts to clean, trace_bounce() then derives raw from it
+#define TRACE_GLITCH_MAX  2   // ticks, spikes trace_bounce() adds on switches at rest
+
+typedef struct {
+	uint32_t *raw;
+	uint32_t *clean;
+	uint32_t  n;
+} trace_t;
+
+uint32_t host_rand   (void);
+uint32_t host_range  (uint32_t lo, uint32_t hi);   // lo..hi inclusive
+
+void trace_alloc  (trace_t *t, uint32_t n);
+void trace_free   (trace_t *t);
+bool trace_load   (trace_t *t, const char *path);   // text, one hex sample per line, '#' comments
+void trace_bounce (trace_t *t, uint32_t bounceMax, uint32_t glitchPer10k);  // raw from clean
+
+// keys pressed one at a time (chordPct of them overlapping the next), from the listed bits
+void trace_typing (trace_t *t, const uint8_t *bits, uint8_t nbits, uint8_t chordPct);
+// strokes along a 12 pad slider at lo..hi pads per second, on the pads from bit shift up
+void trace_swipes (trace_t *t, uint8_t shift, uint16_t lo, uint16_t hi);
+
+
+#define CHECK(cond, ...) do {                                       \
+	if (!(cond)) {                                                  \
+		printf("FAIL %s:%d: ", __FILE__, __LINE__);                 \
+		printf(__VA_ARGS__);                                        \
+		printf("\n");                                               \
+		exit(1);                                                    \
+	}                                                               \
+} while (0)
+
+
+#endif
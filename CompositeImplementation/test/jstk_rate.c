@@ -0,0 +1,89 @@
+/*
+ * jstk_rate.c – Joystick report rate and step response per axis filter
+ *
+ * Purpose: Run the jitter replay (a finger flickering across a pad boundary every frame, as started
+ *          from feature page 0x06) through jstk_usbTask() once per simulated USB frame with each
+ *          filter, and print the reports per second the host would get. Then step a resting
+ *          finger by two half-pads and count the frames until the filtered axis reports exactly
+ *          the new position, and check that steps to both ends of the axis get there too. Also
+ *          checks the replay length and the deadzone at the low end of the axis.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include "conf_joystick.h"
+#include "joystick.h"
+#include "filter.h"
+#include "stats.h"
+
+#include "host.h"
+
+#define RATE_SECONDS   10
+#define SETTLE_REST    200    // frames at the old position before the step
+#define SETTLE_MAX     1000
+
+static const char *const rate_names[] = { "none", "alpha-beta", "one-euro" };
+
+static double rate_replay(uint8_t type) {
+	uint32_t frames = 0;
+	uint32_t sent   = stats.jstkReports;
+
+	filter_setConfig(type, CONFIG_JSTK_HYSTERESIS, CONFIG_JSTK_DEADZONE);
+	jstk_replay(RATE_SECONDS);
+	while (jstk_replayLeft()) {
+		jstk_usbTask();
+		frames++;
+	}
+	sent = stats.jstkReports - sent;
+	jstk_usbTask();                                    // lift-off, back to center
+	CHECK(frames == RATE_SECONDS * 1000UL, "%u replay frames", (unsigned)frames);
+	return (double)sent / RATE_SECONDS;
+}
+
+// frames until a resting finger moved from one axis value to another is reported exactly there
+static uint16_t rate_step(uint8_t type, uint8_t from, uint8_t to) {
+	filter_t f;
+
+	filter_setConfig(type, CONFIG_JSTK_HYSTERESIS, CONFIG_JSTK_DEADZONE);
+	filter_init(&f);
+	for (uint16_t i = 0; i < SETTLE_REST; ++i)
+		filter_update(&f, from, true);
+	for (uint16_t i = 1; i <= SETTLE_MAX; ++i)
+		if (filter_update(&f, to, true) == ((uint16_t)to << 8))
+			return i;
+	CHECK(0, "%s: %u -> %u never reported as %u", rate_names[type], from, to, to);
+	return SETTLE_MAX;
+}
+
+static uint16_t rate_settle(uint8_t type) {
+	rate_step(type, 253, 255);                         // full scale is reached, not held short by the band
+	rate_step(type, 2, 0);
+	return rate_step(type, jstk_posToAxis(10), jstk_posToAxis(12));
+}
+
+int main(void) {
+	host_snapshot.vertIdx = host_snapshot.horiIdx = -1;   // no contact outside the replay
+	host_snapshot.vertPos = host_snapshot.horiPos = -1;
+
+	jstk_replay(66);                                   // past 65.535 s of frames
+	CHECK(jstk_replayLeft() == 66, "replay of 66 s reads back %u s", jstk_replayLeft());
+	jstk_replay(255);
+	CHECK(jstk_replayLeft() == 255, "replay of 255 s reads back %u s", jstk_replayLeft());
+	jstk_replay(0);
+
+	filter_setConfig(FILTER_NONE, 0, 127);             // widest deadzone, axis 0 is 0x8000 below center
+	filter_t f;
+	filter_init(&f);
+	CHECK(filter_update(&f, 0, true) == 0, "axis 0 snapped to center");
+	filter_init(&f);
+	CHECK(filter_update(&f, 128, true) == FILTER_CENTER, "axis 128 not snapped to center");
+
+	printf("jitter replay %u s, hysteresis %u, one frame per ms\n", RATE_SECONDS, CONFIG_JSTK_HYSTERESIS);
+	printf("%-12s %10s %10s\n", "filter", "reports/s", "settle ms");
+	for (uint8_t type = FILTER_NONE; type <= FILTER_ONE_EURO; ++type)
+		printf("%-12s %10.1f %10u\n", rate_names[type], rate_replay(type), rate_settle(type));
+
+	return 0;
+}
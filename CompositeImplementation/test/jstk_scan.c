@@ -0,0 +1,195 @@
+/*
+ * jstk_scan.c – Linked-list vs stamped slider tracking on pad traces
+ *
+ * Purpose: Run slider traces through jstk_poll() on the simulated pads, hand the debounced edges
+ *          to jstk_event() in bit order like the scanner does, and check on every tick that
+ *          jstk_readVertIndex() / jstk_readHoriIndex() report the same pad as the original
+ *          linked-list jstk_scan() fed the same debounced state. Then time both on the recorded
+ *          edge sequence: the old scan once per axis and tick, against the new event path plus
+ *          one index read per axis and tick.
+ *
+ *          jstk_scan [trace ...]   recorded raw pad traces, one hex word per line
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include "joystick.h"
+
+#include "host.h"
+#include "ref.h"
+
+#define BENCH_REPEAT  9
+#define SLIDER_COUNT  12
+#define SLIDER_MASK   ((1u << SLIDER_COUNT) - 1)
+
+// debounced pads and their edges per tick, what both scans get to see
+typedef struct {
+	uint32_t *state;
+	uint32_t *changed;
+	uint32_t  n;
+	uint32_t  edges;
+} pads_t;
+
+static void pads_record(const trace_t *t, pads_t *p) {
+	p->n       = t->n + 1;                  // plus a release of everything, so each pass starts idle
+	p->state   = calloc(p->n, sizeof(uint32_t));
+	p->changed = calloc(p->n, sizeof(uint32_t));
+	p->edges   = 0;
+
+	for (uint32_t i = 0; i < t->n; ++i) {
+		host_setPads(t->raw[i]);
+		p->changed[i] = jstk_poll();
+		p->state[i]   = jstk_getState();
+		p->edges     += __builtin_popcount(p->changed[i]);
+	}
+	for (uint8_t k = 0; k < 16 && jstk_getState(); ++k) {   // let the debouncer release too
+		host_setPads(0);
+		jstk_poll();
+	}
+	CHECK(jstk_getState() == 0, "pads still held after the trace");
+	p->state[t->n]   = 0;
+	p->changed[t->n] = p->state[t->n - 1];
+}
+
+static void pads_free(pads_t *p) {
+	free(p->state);
+	free(p->changed);
+}
+
+static void scan_events(uint32_t changed, uint32_t state) {
+	for (uint32_t e = changed; e; e &= e - 1) {
+		uint8_t bit = ctz(e);
+		jstk_event(bit, (state >> bit) & 1);
+	}
+}
+
+static void scan_check(const pads_t *p) {
+	ref_jstk_init();
+	for (uint32_t i = 0; i < p->n; ++i) {
+		uint32_t s = p->state[i];
+		scan_events(p->changed[i], s);
+		int8_t vert = jstk_readVertIndex();
+		int8_t hori = jstk_readHoriIndex();
+		int8_t refV = ref_jstk_scan(0, ~s & SLIDER_MASK);
+		int8_t refH = ref_jstk_scan(1, ~(s >> SLIDER_COUNT) & SLIDER_MASK);
+		CHECK(vert == refV && hori == refH, "tick %u: pads %06X index %d/%d, linked list %d/%d",
+		      (unsigned)i, (unsigned)s, vert, hori, refV, refH);
+	}
+}
+
+static uint64_t bench_old(const pads_t *p) {
+	uint64_t best = UINT64_MAX;
+
+	for (uint8_t r = 0; r < BENCH_REPEAT; ++r) {
+		volatile int8_t sink;
+		ref_jstk_init();
+		uint64_t t0 = host_cycles();
+		for (uint32_t i = 0; i < p->n; ++i) {
+			sink = ref_jstk_scan(0, ~p->state[i] & SLIDER_MASK);
+			sink = ref_jstk_scan(1, ~(p->state[i] >> SLIDER_COUNT) & SLIDER_MASK);
+		}
+		uint64_t dt = host_cycles() - t0;
+		(void)sink;
+		if (dt < best)
+			best = dt;
+	}
+	return best;
+}
+
+static uint64_t bench_new(const pads_t *p) {
+	uint64_t best = UINT64_MAX;
+
+	for (uint8_t r = 0; r < BENCH_REPEAT; ++r) {
+		volatile int8_t sink;
+		uint64_t t0 = host_cycles();
+		for (uint32_t i = 0; i < p->n; ++i) {
+			scan_events(p->changed[i], p->state[i]);
+			sink = jstk_readVertIndex();
+			sink = jstk_readHoriIndex();
+		}
+		uint64_t dt = host_cycles() - t0;
+		(void)sink;
+		if (dt < best)
+			best = dt;
+	}
+	return best;
+}
+
+static void bench_run(const char *name, const trace_t *t) {
+	pads_t p;
+	double old, new;
+
+	pads_record(t, &p);
+	scan_check(&p);
+	old = (double)bench_old(&p) / p.n;
+	new = (double)bench_new(&p) / p.n;
+	printf("%-12s %7u %7u %9.1f %9.1f\n", name, (unsigned)t->n, (unsigned)p.edges, old, new);
+	pads_free(&p);
+}
+
+// fingers landing and lifting anywhere on both sliders, several at a time
+static void trace_fingers(trace_t *t, uint8_t fingers) {
+	uint32_t pads = 0;
+	uint32_t due[8] = { 0 };
+	uint8_t  at[8];
+
+	for (uint8_t f = 0; f < fingers; ++f)
+		at[f] = 2 * SLIDER_COUNT;                      // lifted
+	for (uint32_t i = 0; i < t->n; ++i) {
+		for (uint8_t f = 0; f < fingers; ++f) {
+			if (i < due[f])
+				continue;
+			at[f]  = (at[f] < 2 * SLIDER_COUNT) ? 2 * SLIDER_COUNT : host_range(0, 2 * SLIDER_COUNT - 1);
+			due[f] = i + host_range(5, 120);
+		}
+		pads = 0;
+		for (uint8_t f = 0; f < fingers; ++f)
+			if (at[f] < 2 * SLIDER_COUNT)
+				pads |= (uint32_t)1 << at[f];
+		t->clean[i] |= pads;
+	}
+}
+
+int main(int argc, char **argv) {
+	trace_t t;
+
+	printf("per scanner tick: host cycles of both axis indexes from the debounced pads\n");
+	printf("%-12s %7s %7s %9s %9s\n", "trace", "ticks", "edges", "old cyc", "new cyc");
+
+	if (argc > 1) {
+		for (int a = 1; a < argc; ++a) {
+			CHECK(trace_load(&t, argv[a]), "cannot read %s", argv[a]);
+			bench_run(argv[a], &t);
+			trace_free(&t);
+		}
+		return 0;
+	}
+
+	trace_alloc(&t, 10000);                            // sliders untouched
+	bench_run("idle", &t);
+	trace_free(&t);
+
+	trace_alloc(&t, 120000);                           // one finger per slider, bouncing pads
+	trace_swipes(&t, 0, 10, 60);
+	trace_swipes(&t, SLIDER_COUNT, 10, 60);
+	trace_bounce(&t, 3, 5);
+	bench_run("swipes", &t);
+	trace_free(&t);
+
+	trace_alloc(&t, 120000);                           // quick strokes
+	trace_swipes(&t, 0, 60, 200);
+	trace_swipes(&t, SLIDER_COUNT, 60, 200);
+	trace_bounce(&t, 3, 5);
+	bench_run("fast swipes", &t);
+	trace_free(&t);
+
+	trace_alloc(&t, 120000);                           // up to five pads held at once
+	trace_fingers(&t, 5);
+	trace_bounce(&t, 3, 5);
+	bench_run("fingers", &t);
+	trace_free(&t);
+
+	return 0;
+}
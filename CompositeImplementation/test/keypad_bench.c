@@ -0,0 +1,128 @@
+/*
+ * keypad_bench.c – Old vs packed keypad scan on matrix traces
+ *
+ * Purpose: Replay keypad matrix traces (one sample per 1 ms scanner tick) through the original
+ *          keyMap[] scan and the packed-matrix keypad_poll(), each followed by the GUI key map,
+ *          and print the host cycles and simulated port accesses per tick. Port accesses go
+ *          through a function in the host model and dominate the host cycles, so the access
+ *          count carries over to the AVR better than the cycles do. Also checks that kbd_getMap()
+ *          of the packed word matches the old keyMap[] on every tick.
+ *
+ *          keypad_bench [trace ...]   recorded traces, one hex matrix word per line
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include "keypad.h"
+
+#include "host.h"
+#include "ref.h"
+
+#define BENCH_REPEAT  9
+
+// matrix bits of the populated keys: NULL, CLEAR, ENTER, CANCEL, Display, F1, F3, F2, F4
+static const uint8_t bench_keys[] = { 0, 1, 4, 5, 8, 14, 15, 18, 19 };
+
+static void bench_check(const trace_t *t) {
+	ref_keypad_init();
+	keypad_init();
+	for (uint32_t i = 0; i < t->n; ++i) {
+		host_setKeys(t->raw[i]);
+		ref_keypad_poll();
+		keypad_poll();
+		CHECK(kbd_getMap(t->raw[i]) == ref_kbd_getMap(),
+		      "tick %u: matrix %05X map %03X, keyMap %03X", (unsigned)i, (unsigned)t->raw[i],
+		      kbd_getMap(t->raw[i]), ref_kbd_getMap());
+	}
+}
+
+static uint64_t bench_old(const trace_t *t, uint32_t *io) {
+	uint64_t best = UINT64_MAX;
+
+	for (uint8_t r = 0; r < BENCH_REPEAT; ++r) {
+		volatile uint16_t sink;
+		ref_keypad_init();
+		host_ioCount = 0;
+		uint64_t t0 = host_cycles();
+		for (uint32_t i = 0; i < t->n; ++i) {
+			host_setKeys(t->raw[i]);
+			ref_keypad_poll();
+			sink = ref_kbd_getMap();
+		}
+		uint64_t dt = host_cycles() - t0;
+		(void)sink;
+		if (dt < best)
+			best = dt;
+		*io = host_ioCount;
+	}
+	return best;
+}
+
+static uint64_t bench_new(const trace_t *t, uint32_t *io) {
+	uint64_t best = UINT64_MAX;
+
+	for (uint8_t r = 0; r < BENCH_REPEAT; ++r) {
+		volatile uint16_t sink;
+		keypad_init();
+		host_ioCount = 0;
+		uint64_t t0 = host_cycles();
+		for (uint32_t i = 0; i < t->n; ++i) {
+			host_setKeys(t->raw[i]);
+			keypad_poll();
+			sink = kbd_getMap(keypad_getMatrix());
+		}
+		uint64_t dt = host_cycles() - t0;
+		(void)sink;
+		if (dt < best)
+			best = dt;
+		*io = host_ioCount;
+	}
+	return best;
+}
+
+static void bench_run(const char *name, const trace_t *t) {
+	uint32_t ioOld, ioNew;
+	double   old, new;
+
+	bench_check(t);
+	old = (double)bench_old(t, &ioOld) / t->n;
+	new = (double)bench_new(t, &ioNew) / t->n;
+	printf("%-12s %7u %9.1f %9.1f %8.1f %8.1f\n", name, (unsigned)t->n, old, new,
+	       (double)ioOld / t->n, (double)ioNew / t->n);
+}
+
+int main(int argc, char **argv) {
+	trace_t t;
+
+	printf("per scanner tick: host cycles of scan + GUI map, port accesses\n");
+	printf("%-12s %7s %9s %9s %8s %8s\n", "trace", "ticks", "old cyc", "new cyc", "old io", "new io");
+
+	if (argc > 1) {
+		for (int a = 1; a < argc; ++a) {
+			CHECK(trace_load(&t, argv[a]), "cannot read %s", argv[a]);
+			bench_run(argv[a], &t);
+			trace_free(&t);
+		}
+		return 0;
+	}
+
+	trace_alloc(&t, 10000);                            // panel untouched
+	bench_run("idle", &t);
+	trace_free(&t);
+
+	trace_alloc(&t, 60000);                            // one key at a time, bouncing contacts
+	trace_typing(&t, bench_keys, sizeof(bench_keys), 0);
+	trace_bounce(&t, 3, 5);
+	bench_run("typing", &t);
+	trace_free(&t);
+
+	trace_alloc(&t, 60000);                            // half the strokes overlap another key
+	trace_typing(&t, bench_keys, sizeof(bench_keys), 50);
+	trace_bounce(&t, 3, 5);
+	bench_run("chords", &t);
+	trace_free(&t);
+
+	return 0;
+}
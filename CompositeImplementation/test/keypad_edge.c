@@ -0,0 +1,67 @@
+/*
+ * keypad_edge.c – Edge-mode key reports for every multipress policy
+ *
+ * Purpose: Feed key edges through keypad_event() one frame at a time and check the key-downs and
+ *          key-ups keypad_report() sends in KEYPAD_REPORT_EDGE mode. A key-down only ever follows
+ *          that key's own press edge: falling back to a key that was held all along, or to one
+ *          that joined a chord, must not send it.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include "keypad.h"
+
+#include "host.h"
+
+#define KEY_A   4     // ENTER, HID 0x28
+#define KEY_B  14     // F1,    HID 0x3A
+
+// one frame: apply the edge, build the report, compare what went to the host
+static void frame(int line, uint8_t bit, bool pressed, const char *expect) {
+	host_kbdLog[0] = '\0';
+	keypad_event(bit, pressed);
+	keypad_report();
+	CHECK(!strcmp(host_kbdLog, expect), "line %d: sent \"%s\", expected \"%s\"", line, host_kbdLog, expect);
+}
+#define FRAME(bit, pressed, expect)  frame(__LINE__, bit, pressed, expect)
+
+static void policy(uint8_t p) {
+	keypad_init();
+	keypad_setReportMode(KEYPAD_REPORT_EDGE);
+	keypad_setMultiPolicy(p);
+}
+
+int main(void) {
+	policy(KEYPAD_MULTI_NEWEST);              // newer key takes over, older one is not sent again
+	FRAME(KEY_A, true,  "+28 ");
+	FRAME(KEY_B, true,  "-28 +3A ");
+	FRAME(KEY_B, false, "-3A ");
+	FRAME(KEY_A, false, "");
+	FRAME(KEY_A, true,  "+28 ");
+	FRAME(KEY_B, true,  "-28 +3A ");
+	FRAME(KEY_A, false, "");
+	FRAME(KEY_B, false, "-3A ");
+
+	policy(KEYPAD_MULTI_FIRST);               // keys joining a chord are never sent
+	FRAME(KEY_A, true,  "+28 ");
+	FRAME(KEY_B, true,  "");
+	FRAME(KEY_A, false, "-28 ");
+	FRAME(KEY_B, false, "");
+	FRAME(KEY_A, true,  "+28 ");
+	FRAME(KEY_B, true,  "");
+	FRAME(KEY_B, false, "");
+	FRAME(KEY_A, false, "-28 ");
+
+	policy(KEYPAD_MULTI_BLOCK);               // a chord takes the key back until all are released
+	FRAME(KEY_A, true,  "+28 ");
+	FRAME(KEY_B, true,  "-28 ");
+	FRAME(KEY_B, false, "");
+	FRAME(KEY_A, false, "");
+	FRAME(KEY_B, true,  "+3A ");
+	FRAME(KEY_B, false, "-3A ");
+
+	printf("edge mode reports ok\n");
+	return 0;
+}
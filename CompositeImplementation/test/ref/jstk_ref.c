@@ -0,0 +1,70 @@
+/*
+ * jstk_ref.c – Slider tracking as it was before the pressed bitmask
+ *
+ * Purpose: Baseline for jstk_scan_test. The trailing-pad jstk_scan() from the original
+ *          joystick.c, renamed: per-axis linked list of the held pads in press order, the head
+ *          (oldest) is reported. Takes the raw, active-low pad bits like the original.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+
+#include "ref.h"
+
+#define SLIDER_COUNT   12
+#define SLIDER_MASK  ((1u << SLIDER_COUNT) - 1)
+
+static int8_t head[2] = {-1, -1};
+static int8_t tail[2] = {-1, -1};
+static int8_t next[2][SLIDER_COUNT];
+static uint8_t inlist[2][SLIDER_COUNT];
+
+void ref_jstk_init(void)
+{
+	head[0] = head[1] = -1;
+	tail[0] = tail[1] = -1;
+	memset(inlist, 0, sizeof(inlist));
+}
+
+int8_t ref_jstk_scan(uint8_t axis, uint16_t bits)
+{
+    uint16_t pressed = (~bits) & SLIDER_MASK;
+
+    for (int8_t i = 0; i < SLIDER_COUNT; i++) {
+        if ((pressed & (1u << i)) && !inlist[axis][i]) {
+            next[axis][i] = -1;
+            if (tail[axis] == -1) {
+                head[axis] = tail[axis] = i;
+            } else {
+                next[axis][tail[axis]] = i;
+                tail[axis] = i;
+            }
+            inlist[axis][i] = 1;
+        }
+    }
+
+    int8_t prev = -1;
+    int8_t curr = head[axis];
+
+    while (curr != -1) {
+        if (!(pressed & (1u << curr))) {
+            if (prev == -1)
+                head[axis] = next[axis][curr];
+            else
+                next[axis][prev] = next[axis][curr];
+
+            if (tail[axis] == curr)
+                tail[axis] = prev;
+
+            inlist[axis][curr] = 0;
+            curr = (prev == -1) ? head[axis] : next[axis][prev];
+        } else {
+            prev = curr;
+            curr = next[axis][curr];
+        }
+    }
+
+    return head[axis];
+}
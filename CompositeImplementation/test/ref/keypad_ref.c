@@ -0,0 +1,147 @@
+/*
+ * keypad_ref.c – Keypad scan as it was before the packed matrix
+ *
+ * Purpose: Baseline for keypad_bench. keypad_poll() and kbd_getMap() from the original keypad.c,
+ *          renamed, with the keymap and column table set up the way keypad_init() did.
+ *
+ * History:
+ *   Created October 17, 2026
+ */
+
+#include <asf.h>
+#include "keypad.h"
+
+#include "ref.h"
+
+static volatile uint8_t kpd_keyAssign[KEYPAD_COLS][KEYPAD_ROWS];
+static volatile uint8_t kpd_colAddr[KEYPAD_COLS];
+
+static volatile uint8_t kpd_keyPressed;
+static volatile uint8_t kpd_code;
+static volatile bool    kpd_multiPress = false;
+
+static bool keyMap[16] = {0};
+static const int8_t keyIndex[KEYPAD_COLS][KEYPAD_ROWS] = {
+	{  8,  7, -1, -1 },
+	{  6,  5, -1, -1 },
+	{  4, -1, -1, -1 },
+	{ -1, -1,  0,  2 },
+	{ -1, -1,  1,  3 },
+};
+
+void ref_keypad_init(void)
+{
+	kpd_keyPressed = KEYPAD_RELEASED;
+	kpd_code = 0;
+
+	kpd_keyAssign[0][0] = HID_N;
+	kpd_keyAssign[0][1] = HID_BACKSPACE;
+	kpd_keyAssign[1][0] = HID_ENTER;
+	kpd_keyAssign[1][1] = HID_ESCAPE;
+	kpd_keyAssign[2][0] = HID_D;
+	kpd_keyAssign[3][2] = HID_F1;
+	kpd_keyAssign[3][3] = HID_F3;
+	kpd_keyAssign[4][2] = HID_F2;
+	kpd_keyAssign[4][3] = HID_F4;
+
+	kpd_colAddr[0] = 0x0E;
+	kpd_colAddr[1] = 0x0D;
+	kpd_colAddr[2] = 0x0B;
+	kpd_colAddr[3] = 0x07;
+	kpd_colAddr[4] = 0xFF;
+}
+
+uint8_t ref_keypad_getCode(void) {
+	return(kpd_code);
+}
+
+void ref_keypad_poll(void)
+{
+	for (int i = 0; i < 9; i++) {
+		keyMap[i] = 0;
+	}
+
+	static uint8_t prevRowMask = 0;
+	uint8_t lastRow = KEYPAD_ROWS, lastCol = KEYPAD_COLS;
+	uint8_t pressedCount = 0;
+
+	for (uint8_t col = 0; col < KEYPAD_COLS; ++col) {
+		PORTF.OUT = kpd_colAddr[col];
+		if (col == 4) {
+			PORTB.OUTCLR = PIN7_bm;
+		} else {
+			PORTB.OUTSET = PIN7_bm;
+		}
+
+		uint8_t rowBits = PORTF.IN & 0xF0;
+		uint8_t rowMask = (~rowBits) & 0xF0;
+
+		if (rowMask & 0x10) pressedCount++;
+		if (rowMask & 0x20) pressedCount++;
+		if (rowMask & 0x40) pressedCount++;
+		if (rowMask & 0x80) pressedCount++;
+
+		for (uint8_t bit = 0; bit < KEYPAD_ROWS; bit++) {
+			if (rowMask & (1 << (bit + 4))) {
+				int8_t idx = keyIndex[col][bit];
+				if (idx >= 0 && idx < 9) {
+					keyMap[idx] = 1;
+				}
+			}
+		}
+
+		uint8_t selectMask;
+		if ((rowMask & (rowMask - 1)) != 0) {
+			uint8_t newMask = rowMask & ~prevRowMask;
+			if (!newMask) {
+				newMask = rowMask;
+			}
+			selectMask = newMask & (uint8_t)(-newMask);
+		} else {
+			selectMask = rowMask;
+		}
+		prevRowMask = rowMask;
+
+		bool pressed = (selectMask != 0);
+		uint8_t rowIndex = 0;
+		switch (selectMask) {
+			case 0x10: rowIndex = 0;     break;
+			case 0x20: rowIndex = 1;     break;
+			case 0x40: rowIndex = 2;     break;
+			case 0x80: rowIndex = 3;     break;
+			default:   pressed  = false; break;
+		}
+		if (pressed) {
+			lastRow = rowIndex;
+			lastCol = col;
+		}
+	}
+	PORTB.OUTSET = PIN7_bm;
+
+	if (lastRow < KEYPAD_ROWS) {
+		uint8_t newCode = kpd_keyAssign[lastCol][lastRow];
+		if (kpd_keyPressed == KEYPAD_RELEASED) {
+			kpd_code = newCode;
+			kpd_keyPressed = KEYPAD_PRESSED;
+		} else if (newCode != kpd_code) {
+			kpd_code = newCode;
+		}
+	} else {
+		if (kpd_keyPressed == KEYPAD_PRESSED) {
+			kpd_keyPressed = KEYPAD_RELEASED;
+		}
+	}
+	kpd_multiPress = (pressedCount > 1);
+}
+
+uint16_t ref_kbd_getMap(void) {
+	uint16_t bits = 0;
+
+	for (uint8_t i = 0; i < 9; ++i) {
+		if (keyMap[i]) {
+			bits |= (1 << i);
+		}
+	}
+
+	return bits;
+}
@@ -0,0 +1,17 @@
+#ifndef REF_H
+#define REF_H
+
+// baseline implementations the rewritten modules are measured and checked against
+
+/* ---------------- keypad ---------------- */
+void     ref_keypad_init    (void);
+void     ref_keypad_poll    (void);
+uint8_t  ref_keypad_getCode (void);
+uint16_t ref_kbd_getMap     (void);
+
+/* ------------- slider scan -------------- */
+void     ref_jstk_init      (void);
+int8_t   ref_jstk_scan      (uint8_t axis, uint16_t bits);
+
+
+#endif